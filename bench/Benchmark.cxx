@@ -0,0 +1,360 @@
+/* Benchmark of the regex engine, run by "make bench".
+ * For every pattern of a few synthetic families, and for every layout, the harness measures the parsing,
+ * the construction and the minimization of the DFA, the memory they take at most, the memory kept by the
+ * minimized DFA, and the matching throughput of the DFA (whole lines, and search through the whole corpus)
+ * and of the NFA. Built with the counters (see 'Counters.hxx'), it reports the work done instead of the
+ * throughputs, which the counting would slow down : "make bench" runs both builds. The search is cut after a few seconds, so a pattern searched in quadratic time reports a
+ * low throughput instead of hanging the benchmark.
+ * The patterns and the corpus are generated from fixed seeds, so two runs work on the same data.
+ *
+ * Usage : bench [corpus size in MiB] [family]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DFA.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+
+/* Memory tracking : every allocation goes through these operators, which keep the current and
+ * the peak amount of allocated bytes. The size is stored before the returned block.
+ */
+namespace
+{
+	std::atomic<size_t> allocatedBytes{ 0 };
+	std::atomic<size_t> peakAllocatedBytes{ 0 };
+
+	constexpr size_t headerSize = alignof(std::max_align_t);
+
+	void* allocate(size_t size)
+	{
+		void* block = std::malloc(size + headerSize);
+		if (block == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		*static_cast<size_t*>(block) = size;
+
+		size_t current = allocatedBytes += size;
+		size_t peak = peakAllocatedBytes.load();
+		while (current > peak && !peakAllocatedBytes.compare_exchange_weak(peak, current)) {}
+
+		return static_cast<char*>(block) + headerSize;
+	}
+
+	void deallocate(void* pointer) noexcept
+	{
+		if (pointer != nullptr)
+		{
+			void* block = static_cast<char*>(pointer) - headerSize;
+			allocatedBytes -= *static_cast<size_t*>(block);
+			std::free(block);
+		}
+	}
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { deallocate(pointer); }
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/* Minimal duration of a throughput measurement */
+	constexpr double minMeasureSeconds = 0.2;
+
+	/* Maximal duration of the search through the corpus */
+	constexpr double maxSearchSeconds = 5;
+
+	/* Seeds of the generated data */
+	constexpr unsigned int corpusSeed = 42;
+	constexpr unsigned int patternSeed = 7;
+
+	double secondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	/* Peak of memory allocated since the call to reset(), above what was allocated at that time */
+	class PeakMemory
+	{
+	public:
+		void reset()
+		{
+			baseline_ = allocatedBytes.load();
+			peakAllocatedBytes = baseline_;
+		}
+
+		size_t get() const
+		{
+			return peakAllocatedBytes.load() - baseline_;
+		}
+
+	private:
+		size_t baseline_ = 0;
+	};
+
+	struct Pattern
+	{
+		std::string family;
+		std::string name;
+		std::string regex;
+	};
+
+	std::string makeWord(std::mt19937& random, size_t minLength, size_t maxLength)
+	{
+		std::string word;
+		size_t length = minLength + random() % (maxLength - minLength + 1);
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			word += static_cast<char>('a' + random() % 26);
+		}
+		return word;
+	}
+
+	std::vector<Pattern> makePatterns()
+	{
+		std::mt19937 random{ patternSeed };
+		std::vector<Pattern> patterns;
+
+		patterns.push_back({ "literal", "short", "timeout" });
+		patterns.push_back({ "literal", "long", "connection reset by peer while reading" });
+
+		patterns.push_back({ "alternation", "4 words", "error|warning|fatal|timeout" });
+		for (size_t wordCount : { 50, 200 })
+		{
+			std::string regex;
+			for (size_t i = 0; i < wordCount; ++i)
+			{
+				regex += (i == 0 ? "" : "|") + makeWord(random, 4, 10);
+			}
+			patterns.push_back({ "alternation", std::to_string(wordCount) + " words", regex });
+		}
+
+		patterns.push_back({ "stars", "nested", "((a*b*)*c*)*d" });
+		patterns.push_back({ "stars", "exponential", "(a|b)*a(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)(a|b)" });
+
+		patterns.push_back({ "ranges", "date", "[0-9][0-9][0-9][0-9]-[0-9][0-9]-[0-9][0-9]" });
+		patterns.push_back({ "ranges", "identifier", "([a-z]|[A-Z])([a-z]|[A-Z]|[0-9])+=[0-9]+" });
+
+		patterns.push_back({ "dot", "two words", ".*error.*timeout.*" });
+		patterns.push_back({ "dot", "spaced", "e.r.o.r" });
+
+		/* The corpus has no 'z', and no "refused" */
+		patterns.push_back({ "nomatch", "dot star", ".*z" });
+		patterns.push_back({ "nomatch", "two words", "error.*refused" });
+		patterns.push_back({ "nomatch", "star", "a*xyz" });
+		patterns.push_back({ "nomatch", "range plus", "[a-b]+z" });
+		patterns.push_back({ "nomatch", "no literal", "[a-e]+(y|z)" });
+
+		return patterns;
+	}
+
+	/* Lines of log-like text, with some of the words the patterns look for */
+	std::vector<std::string> makeCorpus(size_t size)
+	{
+		static const char* const words[] = {
+			"GET", "POST", "user", "request", "served", "in", "ms", "error", "warning", "timeout", "cache",
+			"miss", "hit", "connection", "reset", "by", "peer", "while", "reading", "id=", "status", "ok"
+		};
+
+		std::mt19937 random{ corpusSeed };
+		std::vector<std::string> lines;
+		size_t corpusSize = 0;
+
+		while (corpusSize < size)
+		{
+			std::string line = "2024-0" + std::to_string(1 + random() % 9) + "-1" + std::to_string(random() % 10);
+
+			for (size_t wordCount = 4 + random() % 12; wordCount > 0; --wordCount)
+			{
+				line += ' ';
+				line += (random() % 4 == 0 ? std::to_string(random() % 100000) : words[random() % std::size(words)]);
+			}
+
+			corpusSize += line.size() + 1;
+			lines.push_back(std::move(line));
+		}
+
+		return lines;
+	}
+
+	/* Call f on the lines, over and over, until the minimal duration is reached. Return the throughput in MB/s.
+	 * If 'maxSeconds' is reached before the end of the first pass, only the lines done so far count.
+	 */
+	template<class F>
+	double measureThroughput(const std::vector<std::string>& lines, F&& f, double maxSeconds)
+	{
+		size_t bytes = 0;
+		size_t matches = 0;
+		auto start = Clock::now();
+
+		do
+		{
+			for (const auto& line : lines)
+			{
+				matches += f(line);
+				bytes += line.size();
+
+				if ((bytes & 0xFFF) < line.size() && secondsSince(start) > maxSeconds)
+				{
+					break;
+				}
+			}
+		} while (secondsSince(start) < minMeasureSeconds);
+
+		/* Keep the matching from being optimized out */
+		if (matches == size_t(-1))
+		{
+			std::puts("");
+		}
+
+		return bytes / 1e6 / secondsSince(start);
+	}
+
+	/* Search the corpus for its successive matches, as findAll() does, over and over, until the minimal duration
+	 * is reached. Return the throughput in MB/s. If 'maxSeconds' is reached, only the bytes searched so far count.
+	 */
+	template<class TLayout>
+	double measureSearchThroughput(const DFA<TLayout>& dfa, const std::string& corpus, double maxSeconds)
+	{
+		size_t bytes = 0;
+		auto start = Clock::now();
+
+		do
+		{
+			for (size_t from = 0; from <= corpus.size(); )
+			{
+				auto match = dfa.find(corpus, from);
+				size_t next = (match ? match->end + (match->end == match->start ? 1 : 0) : corpus.size() + 1);
+
+				bytes += std::min(next, corpus.size()) - from;
+				from = next;
+
+				if (secondsSince(start) > maxSeconds)
+				{
+					return bytes / 1e6 / secondsSince(start);
+				}
+			}
+		} while (secondsSince(start) < minMeasureSeconds);
+
+		return bytes / 1e6 / secondsSince(start);
+	}
+
+	template<class TLayout>
+	const char* getLayoutName();
+
+	template<>
+	const char* getLayoutName<MatrixLayout>() { return "Matrix"; }
+
+	template<>
+	const char* getLayoutName<MapLayout>() { return "Map"; }
+
+	template<>
+	const char* getLayoutName<AdjacencyLayout>() { return "Adjacency"; }
+
+	template<class TLayout>
+	void runBenchmark(const Pattern& pattern, const std::vector<std::string>& lines, const std::string& corpus)
+	{
+		PeakMemory peakMemory;
+		peakMemory.reset();
+
+		auto start = Clock::now();
+		NFA<TLayout> nfa = Parser<NFA<TLayout>>::parse(pattern.regex);
+		double parseSeconds = secondsSince(start);
+
+		start = Clock::now();
+		const size_t bytesBeforeDfa = allocatedBytes.load();
+		DFA<TLayout> dfa;
+		dfa.buildFrom(nfa);
+		double buildSeconds = secondsSince(start);
+		Counters buildCounters = dfa.getCounters();
+
+		start = Clock::now();
+		auto minimization = dfa.minimize();
+		double minimizeSeconds = secondsSince(start);
+		size_t peakBytes = peakMemory.get();
+		size_t dfaBytes = allocatedBytes.load() - bytesBeforeDfa;
+
+		std::printf("%-12s %-12s %-10s %9.3f %7zu %9.3f %7zu %7zu %9.3f %9zu %8zu",
+		            pattern.family.c_str(), pattern.name.c_str(), getLayoutName<TLayout>(),
+		            parseSeconds * 1e3, nfa.getStateCount(), buildSeconds * 1e3, minimization.statesBefore, minimization.statesAfter,
+		            minimizeSeconds * 1e3, peakBytes / 1024, dfaBytes / 1024);
+
+		/* The counters cost an atomic addition per byte matched, so the throughputs are only measured without them */
+		if (Counters::enabled)
+		{
+			dfa.resetCounters();
+			for (const auto& line : lines)
+			{
+				dfa.simulate(line);
+			}
+			Counters matchCounters = dfa.getCounters();
+
+			std::printf(" %9zu %9zu %12zu %9s %9s %9s\n", buildCounters.statesBuilt.load(), buildCounters.closuresComputed.load(),
+			            matchCounters.transitionsTaken.load(), "-", "-", "-");
+		}
+		else
+		{
+			double dfaThroughput = measureThroughput(lines, [&dfa](const std::string& line) { return dfa.simulate(line); }, 1e9);
+			double findThroughput = measureSearchThroughput(dfa, corpus, maxSearchSeconds);
+			double nfaThroughput = measureThroughput(lines, [&nfa](const std::string& line) { return nfa.simulate(line); }, minMeasureSeconds);
+
+			std::printf(" %9s %9s %12s %9.1f %9.1f %9.2f\n", "-", "-", "-", dfaThroughput, findThroughput, nfaThroughput);
+		}
+		std::fflush(stdout);
+	}
+}
+
+int main(int argc, char** argv) try
+{
+	size_t corpusSize = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4) * 1024 * 1024;
+	std::string family = (argc > 2 ? argv[2] : "");
+
+	std::vector<std::string> lines = makeCorpus(corpusSize);
+	std::string corpus;
+	for (const auto& line : lines)
+	{
+		corpus += line;
+		corpus += '\n';
+	}
+
+	std::printf("Corpus : %zu lines, %zu bytes (seed %u). Patterns seed %u. Counters %s.\n\n", lines.size(), corpus.size(),
+	            corpusSeed, patternSeed, Counters::enabled ? "enabled" : "disabled");
+	std::printf("%-12s %-12s %-10s %9s %7s %9s %7s %7s %9s %9s %8s %9s %9s %12s %9s %9s %9s\n",
+	            "family", "pattern", "layout", "parse ms", "NFA st", "build ms", "DFA st", "min st", "min ms", "peak KiB", "DFA KiB",
+	            "built", "closures", "transitions", "DFA MB/s", "find MB/s", "NFA MB/s");
+
+	for (const auto& pattern : makePatterns())
+	{
+		if (!family.empty() && pattern.family != family)
+		{
+			continue;
+		}
+
+		runBenchmark<MatrixLayout>(pattern, lines, corpus);
+		runBenchmark<MapLayout>(pattern, lines, corpus);
+		runBenchmark<AdjacencyLayout>(pattern, lines, corpus);
+	}
+
+	return 0;
+}
+catch (const std::exception& e)
+{
+	std::printf("%s\n", e.what());
+	return 1;
+}
@@ -0,0 +1,101 @@
+#ifndef BYTE_CLASSES_HXX
+#define BYTE_CLASSES_HXX
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+#include <Common.hxx>
+
+/* Partition of the 256 byte values into equivalence classes.
+ * Two bytes share a class when every transition of the automaton treats them the same way,
+ * so the automaton only needs one column per class instead of one per byte. The class of a byte
+ * is found through a 256 entries lookup table.
+ */
+class ByteClasses
+{
+public:
+	using ClassId = uint8_t;
+	using ByteSet = std::bitset<256>;
+
+	static constexpr size_t byteCount = 256;
+
+public:
+	/* Default constructor. Every byte is in the same class. */
+	ByteClasses();
+	ByteClasses(const ByteClasses&) = default;
+	ByteClasses(ByteClasses&&) = default;
+
+	ByteClasses& operator=(const ByteClasses&) = default;
+	ByteClasses& operator=(ByteClasses&&) = default;
+
+	/* Build the classes of an automaton, before determinizing it : every range of inputs of the automaton
+	 * (see NFA::getInputRanges()) refines the classes as a whole, so the bytes of a range share a class
+	 * unless an other range tells them apart. All the other bytes (only matched by the any transitions,
+	 * if any) share a single class, the unlabelled class.
+	 */
+	template<class TNFA>
+	static ByteClasses buildFrom(const TNFA& nfa)
+	{
+		ByteClasses result;
+		ByteSet labelledBytes;
+
+		for (const auto& range : nfa.getInputRanges())
+		{
+			if (range.first != any && range.first != epsilon)
+			{
+				ByteSet set;
+				for (int input = range.first; input <= range.second; ++input)
+				{
+					set.set(static_cast<unsigned char>(input));
+				}
+				result.refine(set);
+				labelledBytes |= set;
+			}
+		}
+
+		result.unlabelledByte_ = 0;
+		while (result.unlabelledByte_ < byteCount && labelledBytes[result.unlabelledByte_])
+		{
+			++result.unlabelledByte_;
+		}
+
+		return result;
+	}
+
+	/* Split the classes, so that no class contains both bytes of the set and bytes outside of it */
+	void refine(const ByteSet& set);
+	void refine(unsigned char byte);
+
+	/* Merge classes together. 'classMap' gives the new id of every current class,
+	 * and the new ids must be contiguous, starting from zero.
+	 */
+	void merge(const std::vector<ClassId>& classMap);
+
+	ClassId getClass(unsigned char byte) const noexcept;
+	size_t getClassCount() const noexcept;
+
+	/* Check if some bytes label no transition of the automaton. Their class is the unlabelled class,
+	 * which may also hold labelled bytes once classes are merged.
+	 */
+	bool hasUnlabelledClass() const noexcept;
+	ClassId getUnlabelledClass() const;
+
+	/* Return a byte of the class that can be fed to a NFA transition, meaning it can't be
+	 * mistaken for the none, epsilon or any special inputs.
+	 */
+	Input getRepresentative(ClassId classId) const;
+
+	/* Raw access to the lookup table, for the simulation loops */
+	const ClassId* data() const noexcept;
+
+private:
+	std::array<ClassId, byteCount> classes_;
+	size_t classCount_;
+
+	/* A byte labelling no transition, or byteCount if every byte labels one */
+	size_t unlabelledByte_;
+};
+
+#endif // BYTE_CLASSES_HXX
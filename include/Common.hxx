@@ -81,12 +81,31 @@ public:
 		{
 			auto newRow = std::forward<RowRefType>(row);
 			container_.push_back(State(newStateCount));
-			std::move(newRow.begin(), newRow.end(), container_.back().begin() + oldStateCount);
+
+			/* A row can be longer than the state count if states were removed : ignore the extra transitions */
+			auto rowEnd = newRow.begin() + std::min(newRow.size(), other.getStateCount());
+			std::move(newRow.begin(), rowEnd, container_.back().begin() + oldStateCount);
 		}
 	}
 
 	Input getTransition(StateId from, StateId to) const;
 
+	/* Call 'f(to, input)' for every transition leaving the state */
+	template<class F>
+	void forEachTransition(StateId from, F&& f) const
+	{
+		const State& row = container_[from];
+		const size_t stateCount = std::min(row.size(), getStateCount());
+
+		for (StateId to = 0; to < stateCount; ++to)
+		{
+			if (row[to] != none)
+			{
+				f(to, row[to]);
+			}
+		}
+	}
+
 	size_t getStateCount() const noexcept;
 	void debugDisplay() const;
 
@@ -130,12 +149,95 @@ public:
 	Input getTransition(StateId from, StateId to) const;
 	size_t getStateCount() const;
 
+	/* Call 'f(to, input)' for every transition leaving the state */
+	template<class F>
+	void forEachTransition(StateId from, F&& f) const
+	{
+		for (auto& elem : internalMap_[from])
+		{
+			if (elem.first != none && elem.second < getStateCount())
+			{
+				f(elem.second, elem.first);
+			}
+		}
+	}
+
 	std::vector<StateId> makeTransition(std::vector<StateId> origin, Input input) const;
 
 private:
 	InternalLayoutType internalMap_;
 };
 
+/* Adjacency list layout : every state only stores its outgoing transitions.
+ * Memory is linear in the number of transitions, and appending the states of an other automaton
+ * does not touch the existing ones, which makes it the layout of choice for large automata.
+ * It follows the semantic of the matrix layout : there is at most one transition between two states,
+ * adding a transition with the 'none' input removes it, and the transitions leading to a removed state
+ * are kept, and taken over by the next state added.
+ */
+class AdjacencyLayout
+{
+public:
+	struct Transition
+	{
+		StateId to;
+		Input input;
+	};
+
+	using State = std::vector<Transition>;
+	using InternalLayoutType = std::vector<State>;
+
+public:
+	AdjacencyLayout() = default;
+	AdjacencyLayout(const AdjacencyLayout&) = default;
+	AdjacencyLayout(AdjacencyLayout&&) = default;
+
+	AdjacencyLayout& operator=(const AdjacencyLayout&) = default;
+	AdjacencyLayout& operator=(AdjacencyLayout&&) = default;
+
+	void addState();
+	void removeLastState();
+	void addTransition(StateId from, StateId to, Input input);
+
+	template<class T>
+	auto addStatesOf(T&& other)
+		-> std::enable_if_t<std::is_base_of<AdjacencyLayout, std::remove_reference_t<T>>::value, void>
+	{
+		size_t oldSize = getStateCount();
+
+		for (auto state : other.states_)
+		{
+			for (auto& transition : state)
+			{
+				transition.to += oldSize;
+			}
+			states_.push_back(std::move(state));
+		}
+	}
+
+	Input getTransition(StateId from, StateId to) const;
+	size_t getStateCount() const noexcept;
+
+	/* Call 'f(to, input)' for every transition leaving the state */
+	template<class F>
+	void forEachTransition(StateId from, F&& f) const
+	{
+		for (auto& transition : states_[from])
+		{
+			if (transition.to < getStateCount())
+			{
+				f(transition.to, transition.input);
+			}
+		}
+	}
+
+	std::vector<StateId> makeTransition(std::vector<StateId> origin, Input input) const;
+	void debugDisplay() const;
+
+private:
+	InternalLayoutType states_;
+};
+
 template<class T, class = void>
 struct has_transition_handler : std::false_type
 {};
@@ -188,6 +290,11 @@ public:
 		return TLayout::getStateCount();
 	}
 
+	template<class F>
+	void forEachTransition(StateId from, F&& f) const
+	{
+		TLayout::forEachTransition(from, std::forward<F>(f));
+	}
 
 
 #ifdef DEBUG
@@ -0,0 +1,56 @@
+#ifndef COUNTERS_HXX
+#define COUNTERS_HXX
+
+#include <atomic>
+#include <cstddef>
+
+/* Define REGEX_COUNTERS to make the automata count the work they do, for benchmarking purpose.
+ * Otherwise, the counting compiles to nothing, and the counters stay at zero.
+ * The const methods update the counters too, and an automaton can be shared between threads (see
+ * 'LineScanner.hxx'), so the counters are atomic. Only the totals matter, so they are updated with
+ * relaxed additions.
+ */
+#ifdef REGEX_COUNTERS
+#define REGEX_COUNT(counter, count) ((counter).fetch_add((count), std::memory_order_relaxed))
+#else
+#define REGEX_COUNT(counter, count) ((void)0)
+#endif
+
+/* Work done by an automaton since its construction, or the last reset of its counters */
+struct Counters
+{
+	/* True if the counting is compiled in */
+#ifdef REGEX_COUNTERS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	Counters() = default;
+
+	/* Copies of an automaton copy its counters */
+	Counters(const Counters& other)
+	: statesBuilt{ other.statesBuilt.load(std::memory_order_relaxed) },
+	  closuresComputed{ other.closuresComputed.load(std::memory_order_relaxed) },
+	  transitionsTaken{ other.transitionsTaken.load(std::memory_order_relaxed) }
+	{}
+
+	Counters& operator=(const Counters& other)
+	{
+		statesBuilt.store(other.statesBuilt.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		closuresComputed.store(other.closuresComputed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		transitionsTaken.store(other.transitionsTaken.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		return *this;
+	}
+
+	/* States added to the DFA by the subset construction */
+	std::atomic<size_t> statesBuilt{ 0 };
+
+	/* Epsilon closures computed, by the subset construction or the simulation of a NFA */
+	std::atomic<size_t> closuresComputed{ 0 };
+
+	/* Transitions taken while matching, one per byte read */
+	std::atomic<size_t> transitionsTaken{ 0 };
+};
+
+#endif // COUNTERS_HXX
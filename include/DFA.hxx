@@ -1,131 +1,585 @@
 #ifndef DFA_HXX
 #define DFA_HXX
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
+#include <ByteClasses.hxx>
 #include <Common.hxx>
+#include <Counters.hxx>
 #include <NFA.hxx>
+#include <NFAGraph.hxx>
 #include <Optional.hxx>
+#include <Prefilter.hxx>
+#include <SearchDFA.hxx>
+#include <TransitionTable.hxx>
 
 /* Simple representation of a deterministe finite automaton.
  * One can use a NFA to build a DFA, but it's not possible to perform basic operations like
  * concatenation, union, star, plus and such to a DFA in this library.
  * In fact, this decision was taken because the scope of the library is to provide a small regex engine,
  * and not a fully fledged finite automata library.
+ *
+ * The DFA is compiled into a dense transition table (see 'TransitionTable.hxx'), and the final states are
+ * kept in a bitmap. The table is not indexed by the bytes themselves, but by their equivalence class (see
+ * 'ByteClasses.hxx'), which keeps it small. Matching a string costs two table lookups per byte.
+ * The table is the only representation kept : a layout of the automaton, whose size can be quadratic in
+ * the number of states, is only built on demand, to inspect it (see buildLayout()).
+ *
+ * Some states of the NFA can be tagged when building the DFA. Every DFA state then knows which tags
+ * its NFA states carry, which is how several patterns are told apart once merged in a single automaton
+ * (see 'RegexSet.hxx'). A state is final if it has at least one tag, and without explicit tags, the final
+ * state of the NFA is the only tagged one.
+ *
+ * Besides matching whole strings, the DFA can search for its matches inside a string. The positions
+ * where no match can start are skipped by a prefilter (see 'Prefilter.hxx'), built from the entry state
+ * and from a literal every match contains, and the matches are found by a pair of automata built from
+ * the DFA on the first search, scanning the string once (see 'SearchDFA.hxx').
  */
 template<class TLayout>
-class DFA : public Layout<TLayout>
+class DFA
 {
 public:
-	/* Default constructor */
-	DFA() = default;
+	using Tag = size_t;
+	using TagSet = std::vector<Tag>;
+
+public:
+	/* Default constructor. Will build an automaton matching nothing. */
+	DFA()
+	: entryState_{ 0 },
+	  byteClasses_{},
+	  table_{ byteClasses_.getClassCount() },
+	  finalStates_{},
+	  tagSets_{ TagSet{} },
+	  tagSetOf_{},
+	  requiredLiteral_{},
+	  prefilter_{},
+	  search_{},
+	  counters_{}
+	{
+		sealTable();
+		buildPrefilter();
+		resetSearchDFA();
+	}
 	
 	/* Constructs from a NFA, using the buildFrom() method */
 	template<class NFALayout>
 	DFA(const NFA<NFALayout>& nfa)
+	: DFA()
 	{
 		buildFrom(nfa);
 	}
 	
-	/* Build the DFA from an NFA, using the classic algorithm */
+	/* Build the DFA from an NFA, the final state of the NFA being the only tagged state */
 	template<class NFALayout>
 	void buildFrom(const NFA<NFALayout>& nfa)
 	{
-		/* Compute the epsilon closure from the entry state. This will be the first state of our DFA */
-		std::vector<StateId> currentClosure = nfa.computeEpsilonClosure(std::vector<StateId>{ nfa.getEntryState() });
-		
-		/* Vector to map the resulting states of the DFA */
-		std::vector<std::vector<StateId>> mappedDfaStates;
+		std::vector<StateId> taggedStates;
+		if (nfa.getStateCount() > 0)
+		{
+			taggedStates.push_back(nfa.getStateCount() - 1);
+		}
+
+		buildFrom(nfa, taggedStates);
+	}
+
+	/* Build the DFA from an NFA, using the classic algorithm.
+	 * The subset construction runs on the compressed graph of the NFA (see 'NFAGraph.hxx'), over its byte
+	 * classes rather than over every input : the bytes of a range share a class from the start, so a range
+	 * costs a single transition per state. The DFA states are found back from their NFA state set through a
+	 * hash map. Then, the classes that ended up with the same transitions in every state are merged.
+	 * The tag of taggedStates[i] is i, and a state can carry only one tag.
+	 */
+	template<class NFALayout>
+	void buildFrom(const NFA<NFALayout>& nfa, const std::vector<StateId>& taggedStates)
+	{
+		NFAGraph graph{ nfa };
+		SparseSet workspace{ graph.getStateCount() };
+
+		/* An empty graph has no state to tag */
+		constexpr Tag noTag = std::numeric_limits<Tag>::max();
+		std::vector<Tag> tagOf(graph.getStateCount(), noTag);
+
+		for (Tag tag = 0; tag < taggedStates.size(); ++tag)
+		{
+			if (taggedStates[tag] < graph.getStateCount())
+			{
+				Ensures(tagOf[taggedStates[tag]] == noTag);
+				tagOf[taggedStates[tag]] = tag;
+			}
+		}
+
+		/* Map the state sets of the NFA to the states of the DFA. The map nodes are stable, so the
+		 * vector can refer to the sets stored as keys.
+		 */
+		std::unordered_map<NFAGraph::StateSet, StateId, NFAGraph::StateSetHash> dfaStateIds;
+		std::vector<const NFAGraph::StateSet*> mappedDfaStates;
+		std::vector<size_t> dfaTagSets;
+		std::map<TagSet, size_t> tagSetIds{ { TagSet{}, 0 } };
+		TagSet tags;
 		entryState_ = 0;
+		tagSets_.assign(1, TagSet{});
+		byteClasses_ = ByteClasses::buildFrom(nfa);
+		table_ = TransitionTable{ byteClasses_.getClassCount() };
 
-		/* Add our first state, and set up the requires value for the algorithm */
-		this->addState();
-		mappedDfaStates.push_back(std::move(currentClosure));
+		/* Compute the epsilon closure from the entry state. This will be the first state of our DFA */
+		table_.addState();
+		mappedDfaStates.push_back(&dfaStateIds.emplace(graph.getEntryClosure(workspace), 0).first->first);
+		REGEX_COUNT(counters_.statesBuilt, 1);
+		REGEX_COUNT(counters_.closuresComputed, 1);
 
 		std::stack<StateId> dfaStates;
 		dfaStates.push(0);
 
+		NFAGraph::StateSet newState;
+
 		/* While we still have unexplored states */
 		while (!dfaStates.empty())
 		{
 			StateId currentState = dfaStates.top();
 			dfaStates.pop();
 
-			/* If the DFA state contains a final state of the NFA, mark it final */
-			if (std::find(mappedDfaStates[currentState].begin(), mappedDfaStates[currentState].end(), nfa.getStateCount() - 1) != mappedDfaStates[currentState].end())
+			/* Gather the tags of the NFA states, and share the identical tag sets between DFA states */
+			tags.clear();
+			for (StateId state : *mappedDfaStates[currentState])
 			{
-				finalStates_.push_back(currentState);
+				if (tagOf[state] != noTag)
+				{
+					tags.push_back(tagOf[state]);
+				}
 			}
-			for (Input input : nfa.getPossibleInputs())
+			std::sort(tags.begin(), tags.end());
+
+			auto insertedTags = tagSetIds.emplace(tags, tagSets_.size());
+			if (insertedTags.second)
+			{
+				tagSets_.push_back(tags);
+			}
+			if (dfaTagSets.size() <= currentState)
+			{
+				dfaTagSets.resize(currentState + 1, 0);
+			}
+			dfaTagSets[currentState] = insertedTags.first->second;
+
+			for (size_t classId = 0; classId < byteClasses_.getClassCount(); ++classId)
 			{
+				Input input = byteClasses_.getRepresentative(static_cast<ByteClasses::ClassId>(classId));
+
 				/* Build the next DFA state from the result of the transition */
-				auto newState = nfa.computeEpsilonClosure(nfa.makeTransition(mappedDfaStates[currentState], input));
+				graph.makeTransition(*mappedDfaStates[currentState], input, newState, workspace);
+				REGEX_COUNT(counters_.closuresComputed, 1);
 
 				/* If the transition yields something */
 				if (!newState.empty()) {
-					/* Look in the DFA state table if we already saw this state */
-					auto newStateIdIterator = std::find(mappedDfaStates.begin(), mappedDfaStates.end(), newState);
-					StateId newStateId;
-					
-					/* If not, add a state add a transition, and push the new state id to the unexplored states stack. 
-					 * Else, retrieve the state id.
+					/* Look in the DFA state table if we already saw this state.
+					 * If not, add a state, and push the new state id to the unexplored states stack. 
 					 */
-					if (newStateIdIterator == mappedDfaStates.end())
+					auto inserted = dfaStateIds.emplace(newState, table_.getStateCount());
+					StateId newStateId = inserted.first->second;
+
+					if (inserted.second)
 					{
-						this->addState();
-						newStateId = this->getStateCount() - 1;
-						mappedDfaStates.push_back(newState);
+						table_.addState();
+						REGEX_COUNT(counters_.statesBuilt, 1);
+						mappedDfaStates.push_back(&inserted.first->first);
 						dfaStates.push(newStateId);
 					}
-					else
+					table_.setTransition(currentState, classId, newStateId);
+				}
+
+			}
+		}
+
+		std::vector<bool> isTagged(graph.getStateCount());
+		for (StateId state = 0; state < graph.getStateCount(); ++state)
+		{
+			isTagged[state] = tagOf[state] != noTag;
+		}
+		requiredLiteral_ = graph.findRequiredLiteral(isTagged);
+
+		mergeEquivalentClasses();
+		sealTable();
+
+		for (StateId state = 0; state < dfaTagSets.size(); ++state)
+		{
+			setTagSet(state, dfaTagSets[state]);
+		}
+
+		buildPrefilter();
+		resetSearchDFA();
+	}
+
+	/* Position of a match in a string : the matched bytes are [start, end) */
+	struct Match
+	{
+		size_t start;
+		size_t end;
+	};
+
+	/* State counts of the automaton before and after a minimization */
+	struct MinimizationReport
+	{
+		size_t statesBefore;
+		size_t statesAfter;
+	};
+
+	/* Minimize the DFA, using Hopcroft's partition refinement algorithm.
+	 * States start partitioned by their tag set (final and non final states, for a single tag), and a block of the partition is split as long
+	 * as some of its states lead into a given block for a given class and others do not. Each block then
+	 * becomes a single state. Being equivalent, the classes of bytes are merged again afterwards.
+	 * The dead state takes part in the refinement, so the states that can't reach a final state end up merged into it.
+	 */
+	MinimizationReport minimize()
+	{
+		const size_t stateCount = table_.getStateCount();
+		const size_t classCount = table_.getAlphabetSize();
+		MinimizationReport report{ stateCount - 1, 0 };
+
+		/* Inverse transitions, in compressed form : the states going to 'to' with 'classId' are
+		 * stored in predecessors[offsets[to * classCount + classId]] up to the offset of the next pair.
+		 */
+		std::vector<size_t> offsets(stateCount * classCount + 1, 0);
+		std::vector<StateId> predecessors(stateCount * classCount);
+
+		for (StateId from = 0; from < stateCount; ++from)
+		{
+			for (size_t classId = 0; classId < classCount; ++classId)
+			{
+				++offsets[table_.getTransition(from, classId) * classCount + classId + 1];
+			}
+		}
+		for (size_t i = 1; i < offsets.size(); ++i)
+		{
+			offsets[i] += offsets[i - 1];
+		}
+		{
+			std::vector<size_t> filled(offsets.begin(), offsets.end() - 1);
+			for (StateId from = 0; from < stateCount; ++from)
+			{
+				for (size_t classId = 0; classId < classCount; ++classId)
+				{
+					predecessors[filled[table_.getTransition(from, classId) * classCount + classId]++] = from;
+				}
+			}
+		}
+
+		/* Initial partition : a block per tag set in use */
+		std::vector<std::vector<StateId>> blocks;
+		std::vector<size_t> blockOf(stateCount);
+		{
+			std::vector<size_t> blockOfTagSet(tagSets_.size(), SIZE_MAX);
+			for (StateId state = 0; state < stateCount; ++state)
+			{
+				size_t& block = blockOfTagSet[tagSetOf_[state]];
+				if (block == SIZE_MAX)
+				{
+					block = blocks.size();
+					blocks.emplace_back();
+				}
+				blockOf[state] = block;
+				blocks[block].push_back(state);
+			}
+		}
+
+		/* Pending splitters, as (block, class) pairs */
+		std::vector<std::pair<size_t, size_t>> splitters;
+		std::vector<bool> pendingSplitters(blocks.size() * classCount, false);
+
+		auto addSplitter = [&](size_t block, size_t classId) {
+			pendingSplitters[block * classCount + classId] = true;
+			splitters.emplace_back(block, classId);
+		};
+
+		/* Splitting with every block but one is enough : leave the largest one out */
+		const size_t largestBlock = std::max_element(blocks.begin(), blocks.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.size() < rhs.size();
+		}) - blocks.begin();
+
+		for (size_t block = 0; block < blocks.size(); ++block)
+		{
+			for (size_t classId = 0; classId < classCount && (block != largestBlock || blocks.size() == 1); ++classId)
+			{
+				addSplitter(block, classId);
+			}
+		}
+
+		std::vector<bool> marked(stateCount, false);
+		std::vector<std::vector<StateId>> markedByBlock(stateCount);
+		std::vector<size_t> touchedBlocks;
+
+		while (!splitters.empty())
+		{
+			auto splitter = splitters.back();
+			splitters.pop_back();
+			pendingSplitters[splitter.first * classCount + splitter.second] = false;
+
+			/* Mark the states going into the splitter block with the splitter class */
+			for (StateId to : blocks[splitter.first])
+			{
+				const size_t pair = to * classCount + splitter.second;
+				for (size_t i = offsets[pair]; i < offsets[pair + 1]; ++i)
+				{
+					StateId from = predecessors[i];
+					if (!marked[from])
+					{
+						marked[from] = true;
+						size_t block = blockOf[from];
+						if (markedByBlock[block].empty())
+						{
+							touchedBlocks.push_back(block);
+						}
+						markedByBlock[block].push_back(from);
+					}
+				}
+			}
+
+			/* Split the blocks having both marked and unmarked states */
+			for (size_t block : touchedBlocks)
+			{
+				auto& markedStates = markedByBlock[block];
+
+				if (markedStates.size() < blocks[block].size())
+				{
+					size_t newBlock = blocks.size();
+					auto& oldStates = blocks[block];
+					oldStates.erase(std::remove_if(oldStates.begin(), oldStates.end(), [&marked](StateId state) { return marked[state]; }), oldStates.end());
+
+					for (StateId state : markedStates)
+					{
+						blockOf[state] = newBlock;
+					}
+					blocks.push_back(markedStates);
+					pendingSplitters.resize(blocks.size() * classCount, false);
+
+					for (size_t classId = 0; classId < classCount; ++classId)
 					{
-						newStateId = std::distance(mappedDfaStates.begin(), newStateIdIterator);
+						if (pendingSplitters[block * classCount + classId])
+						{
+							addSplitter(newBlock, classId);
+						}
+						else
+						{
+							addSplitter(blocks[newBlock].size() < blocks[block].size() ? newBlock : block, classId);
+						}
 					}
-					this->addTransition(currentState, newStateId, input);
 				}
 
+				for (StateId state : markedStates)
+				{
+					marked[state] = false;
+				}
+				markedStates.clear();
+			}
+			touchedBlocks.clear();
+		}
+
+		/* Every block becomes a state, except the block of the dead state, recreated by the table */
+		const size_t deadBlock = blockOf[table_.getDeadState()];
+		std::vector<StateId> newStateOf(blocks.size());
+		TransitionTable minimalTable{ classCount };
+
+		for (size_t block = 0; block < blocks.size(); ++block)
+		{
+			if (block != deadBlock)
+			{
+				newStateOf[block] = minimalTable.addState();
+			}
+		}
+		for (size_t block = 0; block < blocks.size(); ++block)
+		{
+			StateId representative = blocks[block].front();
+
+			for (size_t classId = 0; classId < classCount && block != deadBlock; ++classId)
+			{
+				size_t toBlock = blockOf[table_.getTransition(representative, classId)];
+				if (toBlock != deadBlock)
+				{
+					minimalTable.setTransition(newStateOf[block], classId, newStateOf[toBlock]);
+				}
+			}
+		}
+
+		std::vector<size_t> minimalTagSets(minimalTable.getStateCount(), 0);
+		for (size_t block = 0; block < blocks.size(); ++block)
+		{
+			if (block != deadBlock)
+			{
+				minimalTagSets[newStateOf[block]] = tagSetOf_[blocks[block].front()];
 			}
 		}
+
+		const size_t entryBlock = blockOf[entryState_];
+		table_ = std::move(minimalTable);
+		mergeEquivalentClasses();
+		sealTable();
+		entryState_ = (entryBlock == deadBlock ? table_.getDeadState() : newStateOf[entryBlock]);
+		for (StateId state = 0; state < minimalTagSets.size(); ++state)
+		{
+			setTagSet(state, minimalTagSets[state]);
+		}
+
+		buildPrefilter();
+		resetSearchDFA();
+
+		report.statesAfter = table_.getStateCount() - 1;
+		return report;
 	}
 	
 	// TODO : Implement !
 	//void buildFrom(NFA&&);
 	
-	/* Simulate the DFA */
-	bool simulate(std::string str)
+	/* Simulate the DFA. Every byte costs exactly one table lookup : missing transitions lead
+	 * to the dead state, which is never final, so no check is needed inside the loop.
+	 */
+	bool simulate(std::string_view str) const
+	{
+		REGEX_COUNT(counters_.transitionsTaken, str.size());
+
+		return finalStates_[run(str)];
+	}
+
+	/* Simulate the DFA, and return the tags of the state reached at the end of the string.
+	 * Empty if the string is not matched.
+	 */
+	const TagSet& getMatchingTags(std::string_view str) const
+	{
+		REGEX_COUNT(counters_.transitionsTaken, str.size());
+
+		return tagSets_[tagSetOf_[run(str)]];
+	}
+
+	/* Search the string for the leftmost match starting at or after 'from', and among the matches starting
+	 * there, the longest one. Return a nullopt optional if there is none.
+	 * A string without the literal every match contains is rejected at once. Otherwise, the forward search
+	 * automaton finds the end of the match, from one candidate of the prefilter to the next, and the reverse
+	 * one its start, so the bytes are scanned at most once, whether there is a match or not. If the search
+	 * automata were too large to build, the DFA is run from every candidate instead.
+	 */
+	optional<Match> find(std::string_view str, size_t from = 0) const
 	{
-		optional<StateId> currentState{ getEntryState() };
-		for (auto c : str)
+		Ensures(from <= str.size());
+
+		const char* first = str.data();
+		const char* last = first + str.size();
+
+		if (!prefilter_.containsRequiredLiteral(first + from, last))
 		{
-			currentState = makeTransition(*currentState, c);
-			if (!currentState) {
-				return false;
-			}
+			return {};
+		}
+
+		const SearchDFA& search = getSearchDFA();
+		if (!search.isEnabled())
+		{
+			return findFromEveryCandidate(first, prefilter_.find(first + from, last), last);
 		}
-		if (std::find(finalStates_.begin(), finalStates_.end(), *currentState) != finalStates_.end())
+
+		const char* end = search.findEnd(first + from, last, prefilter_, counters_);
+		if (end == nullptr)
 		{
-			return true;
+			return {};
 		}
-		return false;
+
+		return Match{ static_cast<size_t>(search.findStart(first + from, end, counters_) - first), static_cast<size_t>(end - first) };
 	}
 
-	/* Perform the transition. Return a nullopt optional if no transition exists from this state for this input */
-	optional<StateId> makeTransition(StateId from, Input input)
+	/* Return the successive matches of the string, as found by find(). The search resumes at the end of
+	 * the previous match, or one byte further if the match was empty.
+	 */
+	std::vector<Match> findAll(std::string_view str) const
 	{
-		optional<StateId> result;
-		for (StateId s = 0; s < this->getStateCount(); ++s)
+		std::vector<Match> matches;
+
+		for (size_t from = 0; from <= str.size(); )
 		{
-			if (this->getTransition(from, s) == input)
+			auto match = find(str, from);
+			if (!match)
 			{
-				result = s;
 				break;
 			}
+
+			matches.push_back(*match);
+			from = match->end + (match->end == match->start ? 1 : 0);
 		}
-		return result;
+
+		return matches;
+	}
+
+	/* Perform the transition. Return a nullopt optional if no transition exists from this state for this input */
+	optional<StateId> makeTransition(StateId from, Input input) const
+	{
+		StateId to = table_.getTransition(from, byteClasses_.getClass(static_cast<unsigned char>(input)));
+
+		if (to == table_.getDeadState())
+		{
+			return {};
+		}
+		return to;
+	}
+
+	/* Check if the state is final. The dead state is never final. */
+	bool isFinal(StateId state) const
+	{
+		Ensures(state < finalStates_.size());
+
+		return finalStates_[state];
+	}
+
+	/* Return the tags of the state, sorted. The dead state has none. */
+	const TagSet& getTags(StateId state) const
+	{
+		Ensures(state < tagSetOf_.size());
+
+		return tagSets_[tagSetOf_[state]];
+	}
+
+	/* Return the byte classes indexing the transition table */
+	const ByteClasses& getByteClasses() const noexcept
+	{
+		return byteClasses_;
+	}
+
+	/* Return the work done by the construction and the simulations (see 'Counters.hxx') */
+	const Counters& getCounters() const noexcept
+	{
+		return counters_;
+	}
+
+	void resetCounters() noexcept
+	{
+		counters_ = Counters{};
+	}
+
+	/* Return the prefilter used by find() */
+	const Prefilter& getPrefilter() const noexcept
+	{
+		return prefilter_;
+	}
+
+	/* Return the search automata used by find(), building them on the first call. The copies of the DFA
+	 * share them, and the threads searching the same DFA build them once.
+	 */
+	const SearchDFA& getSearchDFA() const
+	{
+		LazySearchDFA& lazy = *search_;
+		std::call_once(lazy.built, [&]() {
+			lazy.search = SearchDFA{ table_, finalStates_, entryState_, byteClasses_ };
+		});
+		return lazy.search;
+	}
+
+	/* Return the compiled transition table */
+	const TransitionTable& getTable() const noexcept
+	{
+		return table_;
 	}
 
 	/* Return the entry state */
@@ -134,9 +588,306 @@ public:
 		return entryState_;
 	}
 
+	/* Return the number of states, the dead state excluded */
+	size_t getStateCount() const noexcept
+	{
+		return table_.getStateCount() - 1;
+	}
+
+	/* Call 'f(to, input)' for every input leaving the state, like the layouts do : every byte labelling a NFA
+	 * transition is an input of its own, and the bytes of the unlabelled class (see 'ByteClasses.hxx') are given
+	 * as the any input. Every byte goes at least where these bytes go, so reading the any input as matching
+	 * every byte adds no match. Several inputs can lead to the same state, and the transitions to the dead
+	 * state are left out. The special inputs can't label a NFA transition, so they are never given as bytes.
+	 */
+	template<class F>
+	void forEachTransition(StateId from, F&& f) const
+	{
+		const StateId deadState = table_.getDeadState();
+		const bool hasUnlabelledClass = byteClasses_.hasUnlabelledClass();
+		const size_t unlabelledClass = hasUnlabelledClass ? byteClasses_.getUnlabelledClass() : ByteClasses::byteCount;
+
+		if (hasUnlabelledClass && table_.getTransition(from, unlabelledClass) != deadState)
+		{
+			f(table_.getTransition(from, unlabelledClass), any);
+		}
+
+		for (size_t byte = 0; byte < ByteClasses::byteCount; ++byte)
+		{
+			Input input = static_cast<Input>(byte);
+			size_t classId = byteClasses_.getClass(static_cast<unsigned char>(byte));
+			StateId to = table_.getTransition(from, classId);
+
+			if (to != deadState && classId != unlabelledClass && input != none && input != epsilon && input != any)
+			{
+				f(to, input);
+			}
+		}
+	}
+
+	/* Return the input of the first transition between the two states, as given by forEachTransition(), or none */
+	Input getTransition(StateId from, StateId to) const
+	{
+		Input result = none;
+		forEachTransition(from, [to, &result](StateId reached, Input input) {
+			if (reached == to && result == none)
+			{
+				result = input;
+			}
+		});
+
+		return result;
+	}
+
+	/* Build the layout of the automaton, to inspect it. The layout is not kept.
+	 * The states of the DFA keep their ids. A layout has a single transition between two states, so when
+	 * several inputs lead from a state to the same one, every input but the first goes through an extra
+	 * state, added after those of the DFA, and left by an epsilon transition.
+	 */
+	Layout<TLayout> buildLayout() const
+	{
+		Layout<TLayout> layout;
+
+		for (StateId state = 0; state < getStateCount(); ++state)
+		{
+			layout.addState();
+		}
+		for (StateId from = 0; from < getStateCount(); ++from)
+		{
+			forEachTransition(from, [this, &layout, from](StateId to, Input input) {
+				if (getTransition(from, to) == input)
+				{
+					layout.addTransition(from, to, input);
+					return;
+				}
+
+				StateId extraState = layout.getStateCount();
+				layout.addState();
+				layout.addTransition(from, extraState, input);
+				layout.addTransition(extraState, to, epsilon);
+			});
+		}
+
+		return layout;
+	}
+
+#ifdef DEBUG
+	void debugDisplay() const
+	{
+		buildLayout().debugDisplay();
+	}
+#endif
+
 private:
+	/* Run the DFA on the string, and return the state reached */
+	TransitionTable::Entry run(std::string_view str) const
+	{
+		const TransitionTable::Entry* next = table_.data();
+		const ByteClasses::ClassId* classes = byteClasses_.data();
+		const size_t classCount = table_.getAlphabetSize();
+		TransitionTable::Entry state = static_cast<TransitionTable::Entry>(entryState_);
+
+		for (unsigned char c : str)
+		{
+			state = next[state * classCount + classes[c]];
+		}
+
+		return state;
+	}
+
+	/* Run the DFA from every candidate of the prefilter, starting with 'start', until a match is found */
+	optional<Match> findFromEveryCandidate(const char* first, const char* start, const char* last) const
+	{
+		for (; ; ++start)
+		{
+			start = prefilter_.find(start, last);
+
+			if (const char* end = findLongestMatch(start, last))
+			{
+				return Match{ static_cast<size_t>(start - first), static_cast<size_t>(end - first) };
+			}
+			if (start == last)
+			{
+				return {};
+			}
+		}
+	}
+
+	/* Run the DFA from 'first', and return the end of the longest match starting there, or nullptr if there is none.
+	 * The run stops as soon as the dead state is reached.
+	 */
+	const char* findLongestMatch(const char* first, const char* last) const
+	{
+		const TransitionTable::Entry* next = table_.data();
+		const ByteClasses::ClassId* classes = byteClasses_.data();
+		const size_t classCount = table_.getAlphabetSize();
+		const TransitionTable::Entry deadState = static_cast<TransitionTable::Entry>(table_.getDeadState());
+		TransitionTable::Entry state = static_cast<TransitionTable::Entry>(entryState_);
+
+		const char* matchEnd = finalStates_[state] ? first : nullptr;
+		[[maybe_unused]] const char* start = first;
+
+		while (first != last)
+		{
+			state = next[state * classCount + classes[static_cast<unsigned char>(*first++)]];
+
+			if (state == deadState)
+			{
+				break;
+			}
+			if (finalStates_[state])
+			{
+				matchEnd = first;
+			}
+		}
+
+		REGEX_COUNT(counters_.transitionsTaken, static_cast<size_t>(first - start));
+
+		return matchEnd;
+	}
+
+	/* Drop the search automata of the previous transition table. They are built again by the next search. */
+	void resetSearchDFA()
+	{
+		search_ = std::make_shared<LazySearchDFA>();
+	}
+
+	/* Build the prefilter from the bytes leaving the entry state. While a single byte leaves a non final
+	 * state, every match goes through it, so the literal prefix is the path of such bytes from the entry state.
+	 * The required literal was found in the NFA (see NFAGraph::findRequiredLiteral()), as the DFA states of
+	 * "error.*timeout" have no single path to follow.
+	 * If the entry state is final, the empty string matches at every position, and there is nothing to skip.
+	 */
+	void buildPrefilter()
+	{
+		if (finalStates_[entryState_])
+		{
+			prefilter_ = Prefilter{};
+			return;
+		}
+
+		const StateId deadState = table_.getDeadState();
+		ByteClasses::ByteSet leavingBytes;
+		unsigned char lastLeavingByte = 0;
+
+		auto computeLeavingBytes = [&](StateId state) {
+			leavingBytes.reset();
+			for (size_t byte = 0; byte < ByteClasses::byteCount; ++byte)
+			{
+				if (table_.getTransition(state, byteClasses_.getClass(static_cast<unsigned char>(byte))) != deadState)
+				{
+					leavingBytes.set(byte);
+					lastLeavingByte = static_cast<unsigned char>(byte);
+				}
+			}
+		};
+
+		computeLeavingBytes(entryState_);
+		const ByteClasses::ByteSet firstBytes = leavingBytes;
+
+		std::string prefix;
+		StateId state = entryState_;
+
+		while (leavingBytes.count() == 1 && !finalStates_[state] && prefix.size() < table_.getStateCount())
+		{
+			prefix.push_back(static_cast<char>(lastLeavingByte));
+			state = table_.getTransition(state, byteClasses_.getClass(lastLeavingByte));
+			computeLeavingBytes(state);
+		}
+
+		prefilter_ = Prefilter{ firstBytes, std::move(prefix), requiredLiteral_ };
+	}
+
+	/* Give the state the tag set of index 'tagSet', the state being final if the set is not empty */
+	void setTagSet(StateId state, size_t tagSet)
+	{
+		tagSetOf_[state] = tagSet;
+		finalStates_[state] = !tagSets_[tagSet].empty();
+	}
+
+	/* Bytes labelling different NFA transitions may still lead to the same DFA states (the bytes of
+	 * a range for example). Merge the classes having the same column in the table, and rebuild it.
+	 */
+	void mergeEquivalentClasses()
+	{
+		const size_t stateCount = table_.getStateCount();
+		const size_t classCount = table_.getAlphabetSize();
+
+		std::map<std::vector<TransitionTable::Entry>, ByteClasses::ClassId> columns;
+		std::vector<ByteClasses::ClassId> classMap(classCount);
+		std::vector<size_t> keptClasses;
+
+		for (size_t classId = 0; classId < classCount; ++classId)
+		{
+			std::vector<TransitionTable::Entry> column(stateCount);
+			for (StateId state = 0; state < stateCount; ++state)
+			{
+				column[state] = table_.getTransition(state, classId);
+			}
+
+			auto inserted = columns.emplace(std::move(column), static_cast<ByteClasses::ClassId>(keptClasses.size()));
+			if (inserted.second)
+			{
+				keptClasses.push_back(classId);
+			}
+			classMap[classId] = inserted.first->second;
+		}
+
+		if (keptClasses.size() == classCount)
+		{
+			return;
+		}
+
+		TransitionTable mergedTable{ keptClasses.size() };
+		for (StateId state = 0; state < stateCount; ++state)
+		{
+			mergedTable.addState();
+		}
+		for (StateId state = 0; state < stateCount; ++state)
+		{
+			for (size_t classId = 0; classId < keptClasses.size(); ++classId)
+			{
+				auto to = table_.getTransition(state, keptClasses[classId]);
+				if (to != TransitionTable::unset)
+				{
+					mergedTable.setTransition(state, classId, to);
+				}
+			}
+		}
+
+		table_ = std::move(mergedTable);
+		byteClasses_.merge(classMap);
+	}
+
+	/* Add the dead state to the table, and size the final states bitmap and the tags accordingly */
+	void sealTable()
+	{
+		table_.seal();
+		finalStates_.assign(table_.getStateCount(), false);
+		tagSetOf_.assign(table_.getStateCount(), 0);
+	}
+
 	StateId entryState_;
-	std::vector<StateId> finalStates_;
+	ByteClasses byteClasses_;
+	TransitionTable table_;
+	std::vector<bool> finalStates_;
+
+	/* The distinct tag sets, the first one being empty, and the index of the tag set of every state */
+	std::vector<TagSet> tagSets_;
+	std::vector<size_t> tagSetOf_;
+
+	/* Literal every match contains, found when building from the NFA, and kept through the minimization */
+	std::string requiredLiteral_;
+	Prefilter prefilter_;
+
+	/* Search automata, built by the first search (see getSearchDFA()) */
+	struct LazySearchDFA
+	{
+		std::once_flag built;
+		SearchDFA search;
+	};
+	std::shared_ptr<LazySearchDFA> search_;
+	mutable Counters counters_;
 };
 
 #endif // DFA_HXX
\ No newline at end of file
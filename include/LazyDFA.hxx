@@ -0,0 +1,124 @@
+#ifndef LAZY_DFA_HXX
+#define LAZY_DFA_HXX
+
+#include <array>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <ByteClasses.hxx>
+#include <Common.hxx>
+#include <NFA.hxx>
+#include <NFAGraph.hxx>
+#include <TransitionTable.hxx>
+
+/* Deterministic automaton built on demand from a NFA.
+ * Instead of computing every state up front, as DFA::buildFrom does, the states are computed while
+ * simulating, only when the input reaches them, and kept in a cache. The cache is bounded in memory :
+ * when it is full, it is flushed, and the states needed afterwards are computed again. If a simulation
+ * keeps flushing the cache without scanning enough bytes per cached state in between, the input is not
+ * worth the cache, and the rest of it is matched by simulating the NFA directly.
+ * This way, the memory used stays predictable even for patterns whose DFA is exponentially large,
+ * while usual inputs run at the speed of the DFA once the states they need are cached.
+ *
+ * As it fills its cache, the simulation modifies the automaton, so an instance can't be shared
+ * between threads.
+ */
+class LazyDFA
+{
+public:
+	/* Default memory budget of the cache, in bytes */
+	static constexpr size_t defaultCacheCapacity = 2 * 1024 * 1024;
+
+	/* Default number of inefficient flushes a simulation can do, before falling back to the NFA */
+	static constexpr size_t defaultMaxFlushCount = 3;
+
+	/* A flush is inefficient if less than this many bytes were scanned per cached state since the previous one */
+	static constexpr size_t minBytesPerState = 10;
+
+	/* Id of the state reached when no NFA state is left. Always in the cache. */
+	static constexpr StateId deadState = 0;
+
+public:
+	/* Build the lazy automaton of a NFA. Only the dead state and the entry state are computed. */
+	template<class NFALayout>
+	explicit LazyDFA(const NFA<NFALayout>& nfa, size_t cacheCapacity = defaultCacheCapacity, size_t maxFlushCount = defaultMaxFlushCount)
+	: graph_{ nfa },
+	  byteClasses_{ ByteClasses::buildFrom(nfa) },
+	  representatives_{},
+	  workspace_{ graph_.getStateCount() },
+	  cache_{ byteClasses_.getClassCount() },
+	  stateIds_{},
+	  states_{},
+	  finalStates_{},
+	  cacheCapacity_{ cacheCapacity },
+	  cacheMemory_{ 0 },
+	  maxFlushCount_{ maxFlushCount },
+	  flushCount_{ 0 },
+	  entryState_{ 0 }
+	{
+		for (size_t classId = 0; classId < byteClasses_.getClassCount(); ++classId)
+		{
+			representatives_[classId] = byteClasses_.getRepresentative(static_cast<ByteClasses::ClassId>(classId));
+		}
+
+		flush();
+	}
+
+	LazyDFA(const LazyDFA&) = delete;
+	LazyDFA(LazyDFA&&) = default;
+
+	LazyDFA& operator=(const LazyDFA&) = delete;
+	LazyDFA& operator=(LazyDFA&&) = default;
+
+	/* Simulate the automaton, computing the missing states on the way */
+	bool simulate(std::string_view str);
+
+	/* Empty the cache, keeping only the dead and entry states */
+	void flush();
+
+	/* Number of states currently in the cache, dead state included */
+	size_t getCachedStateCount() const noexcept;
+
+	/* Estimation of the memory used by the cache, in bytes */
+	size_t getCacheMemory() const noexcept;
+	size_t getCacheCapacity() const noexcept;
+
+	/* Number of times the cache was flushed since the construction */
+	size_t getFlushCount() const noexcept;
+
+	StateId getEntryState() const noexcept;
+
+private:
+	/* Compute the state reached from 'from' with the class, and cache it. If the cache gets flushed,
+	 * the returned state is the only one kept along with the dead and entry states.
+	 */
+	StateId computeTransition(StateId from, size_t classId);
+
+	/* Add a state to the cache, without checking the memory budget */
+	StateId addState(NFAGraph::StateSet&& states);
+
+	/* Memory taken by a state in the cache */
+	size_t getStateMemory(const NFAGraph::StateSet& states) const noexcept;
+
+	/* Finish the simulation on the NFA, starting from the states of 'from' */
+	bool simulateNFA(StateId from, std::string_view str);
+
+	NFAGraph graph_;
+	ByteClasses byteClasses_;
+	std::array<Input, ByteClasses::byteCount> representatives_;
+	SparseSet workspace_;
+
+	TransitionTable cache_;
+	std::unordered_map<NFAGraph::StateSet, StateId, NFAGraph::StateSetHash> stateIds_;
+	std::vector<const NFAGraph::StateSet*> states_;
+	std::vector<bool> finalStates_;
+
+	size_t cacheCapacity_;
+	size_t cacheMemory_;
+	size_t maxFlushCount_;
+	size_t flushCount_;
+	StateId entryState_;
+};
+
+#endif // LAZY_DFA_HXX
@@ -0,0 +1,115 @@
+#ifndef LINE_SCANNER_HXX
+#define LINE_SCANNER_HXX
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <DFA.hxx>
+#include <ThreadPool.hxx>
+
+/* Search of the lines of a text containing a match of a DFA, like grep does.
+ * The text is cut into chunks of about the same size, ending on line boundaries, and the chunks are
+ * searched in parallel by the threads of a pool. The DFA is only read, so all the threads share it.
+ * The lines are views into the text, which is not copied : a mapped file (see 'MappedFile.hxx') can be
+ * searched as a whole, without being loaded in memory first.
+ */
+template<class TLayout>
+class LineScanner
+{
+public:
+	/* Default size of the chunks, in bytes */
+	static constexpr size_t defaultChunkSize = 1024 * 1024;
+
+	/* A line containing a match. The numbers start at 1, and the text excludes the end of line. */
+	struct Line
+	{
+		size_t number;
+		std::string_view text;
+	};
+
+public:
+	/* The DFA and the pool must outlive the scanner */
+	LineScanner(const DFA<TLayout>& dfa, ThreadPool& pool, size_t chunkSize = defaultChunkSize)
+	: dfa_{ dfa },
+	  pool_{ pool },
+	  chunkSize_{ std::max<size_t>(chunkSize, 1) }
+	{}
+
+	LineScanner(const LineScanner&) = delete;
+	LineScanner& operator=(const LineScanner&) = delete;
+
+	/* Return the lines of the text containing a match, in order */
+	std::vector<Line> scan(std::string_view text) const
+	{
+		/* Cut the text after the first end of line following every chunk size */
+		std::vector<std::string_view> chunks;
+		for (size_t first = 0; first < text.size(); )
+		{
+			size_t last = std::min(first + chunkSize_, text.size());
+			const void* endOfLine = std::memchr(text.data() + last - 1, '\n', text.size() - last + 1);
+			last = endOfLine ? static_cast<const char*>(endOfLine) - text.data() + 1 : text.size();
+
+			chunks.push_back(text.substr(first, last - first));
+			first = last;
+		}
+
+		/* The line numbers of a chunk depend on the line counts of the previous ones, so they are
+		 * numbered from the start of the chunk, and shifted afterwards.
+		 */
+		std::vector<std::vector<Line>> chunkLines(chunks.size());
+		std::vector<size_t> chunkLineCounts(chunks.size());
+
+		for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+		{
+			pool_.submit([this, chunk, &chunks, &chunkLines, &chunkLineCounts] {
+				chunkLineCounts[chunk] = scanChunk(chunks[chunk], chunkLines[chunk]);
+			});
+		}
+		pool_.wait();
+
+		std::vector<Line> lines;
+		size_t previousLineCount = 0;
+
+		for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+		{
+			for (const auto& line : chunkLines[chunk])
+			{
+				lines.push_back({ line.number + previousLineCount, line.text });
+			}
+			previousLineCount += chunkLineCounts[chunk];
+		}
+
+		return lines;
+	}
+
+private:
+	/* Add the matching lines of the chunk, numbered from the start of the chunk, and return its line count */
+	size_t scanChunk(std::string_view chunk, std::vector<Line>& lines) const
+	{
+		size_t lineCount = 0;
+
+		while (!chunk.empty())
+		{
+			size_t endOfLine = std::min(chunk.find('\n'), chunk.size());
+			std::string_view line = chunk.substr(0, endOfLine);
+			++lineCount;
+
+			if (dfa_.find(line))
+			{
+				lines.push_back({ lineCount, line });
+			}
+
+			chunk.remove_prefix(std::min(endOfLine + 1, chunk.size()));
+		}
+
+		return lineCount;
+	}
+
+	const DFA<TLayout>& dfa_;
+	ThreadPool& pool_;
+	size_t chunkSize_;
+};
+
+#endif // LINE_SCANNER_HXX
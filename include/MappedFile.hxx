@@ -0,0 +1,53 @@
+#ifndef MAPPED_FILE_HXX
+#define MAPPED_FILE_HXX
+
+#include <exception>
+#include <string>
+#include <string_view>
+
+class MappedFileException : public std::exception
+{
+public:
+	MappedFileException(std::string msg) : msg_{msg}
+	{}
+
+	const char* what() const noexcept override
+	{
+		return msg_.c_str();
+	}
+
+private:
+	std::string msg_;
+};
+
+/* Read only file mapped in memory.
+ * The content of the file is read by the system on demand, as the pages are accessed, so a large file
+ * is matched without being copied into a buffer first. Throws a MappedFileException if the file can't be
+ * opened or mapped.
+ */
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	const char* data() const noexcept;
+	size_t size() const noexcept;
+
+	/* Return the whole content of the file */
+	std::string_view getContent() const noexcept;
+
+private:
+	void unmap() noexcept;
+
+	const char* data_;
+	size_t size_;
+};
+
+#endif // MAPPED_FILE_HXX
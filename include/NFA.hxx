@@ -5,11 +5,13 @@
 #include <cstdint>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <iostream>
 
 #include <Common.hxx>
+#include <Counters.hxx>
 
 
 
@@ -19,12 +21,18 @@
 template<class TLayout>
 class NFA : public Layout<TLayout>
 {
+public:
+	/* Range of inputs, the bounds included */
+	using InputRange = std::pair<Input, Input>;
+
 public:
 	/* Default constructor. Will build an empty automaton. */
 	NFA()
 	: Layout<TLayout>(),
 		entryState_{ 0 },
-		possibleInputs_{}
+		possibleInputs_{},
+		inputRanges_{},
+		counters_{}
 	{}
 
 	/* Converting constructor from single input.
@@ -33,7 +41,9 @@ public:
 	NFA(Input input)
 	: Layout<TLayout>(),
 	  entryState_{0},
-	  possibleInputs_{}
+	  possibleInputs_{},
+	  inputRanges_{},
+	  counters_{}
 	{
 		this->addState();
 		this->addState();
@@ -43,9 +53,44 @@ public:
 		if (input != epsilon)
 		{
 			possibleInputs_.insert(input);
+			inputRanges_.emplace(input, input);
 		}
 	}
 	
+	/* Converting constructor from a range of inputs.
+	 * Will build an automaton matching any input of the range. Every input goes through its own
+	 * state, reached by epsilon from the entry state, but all of them lead to the same final state.
+	 * These states are always reached together, so the inputs of the range can share a byte class
+	 * when building the DFA (see getInputRanges()).
+	 */
+	NFA(Input first, Input last)
+	: NFA()
+	{
+		Ensures(first <= last);
+
+		if (first == last)
+		{
+			*this = NFA(first);
+			return;
+		}
+
+		for (int input = first; input <= last + 2; ++input)
+		{
+			this->addState();
+		}
+
+		StateId finalState = this->getStateCount() - 1;
+		StateId inputState = entryState_ + 1;
+
+		for (int input = first; input <= last; ++input, ++inputState)
+		{
+			this->addTransition(entryState_, inputState, epsilon);
+			this->addTransition(inputState, finalState, static_cast<Input>(input));
+			possibleInputs_.insert(static_cast<Input>(input));
+		}
+		inputRanges_.emplace(first, last);
+	}
+
 	/* Defaulted copy/move constructors */
 	NFA(const NFA& other) = default;
 	NFA(NFA&& other) = default;
@@ -54,10 +99,15 @@ public:
 	NFA& operator=(const NFA& other) = default;
 	NFA& operator=(NFA&&) = default;
 
-	/* Concatenation with an other automaton. */
+	/* Concatenation with an other automaton. An empty automaton, as built from "()", changes nothing. */
 	void concatenate(const NFA& other)
 	{
 		this->insertNewInputs(other);
+
+		if (other.getStateCount() == 0)
+		{
+			return;
+		}
 		
 		size_t oldSize = this->getStateCount();
 		StateId oldLastState = oldSize > 0 ? oldSize - 1 : 0;
@@ -129,21 +179,24 @@ public:
 		this->addStatesOf(other);
 		StateId lastOtherState = other.getStateCount() - 1;
 
-		StateId newFirstState = 0;
 		StateId newLastState = oldLastState;
 		
 		/* Check if this automaton, or the automaton to make union with is already in a "unified" form,
 		 * meaning it already had a union operation applied to it.
 		 * If so, an optimized operation is performed, resulting in less states in the final automaton.
+		 * The final state of the other automaton then becomes the final state of the union, so it must not
+		 * have any outgoing transition.
 		 */
-		if(other.isUnified())
+		bool canReuseLastOtherState = !other.hasOutgoingTransition(lastOtherState);
+
+		if(canReuseLastOtherState && other.isUnified())
 		{
 			entryState_ = other.getEntryState() + oldSize;
 			
-			this->addTransition(oldLastState, lastOtherState, epsilon);
+			this->addTransition(oldLastState, lastOtherState + oldSize, epsilon);
 			this->addTransition(getEntryState(), oldEntryState, epsilon);
 		}
-		else if(this->isUnified())
+		else if(canReuseLastOtherState && this->isUnified())
 		{
 			this->addTransition(oldLastState, lastOtherState + oldSize, epsilon);
 			this->addTransition(getEntryState(), other.getEntryState() + oldSize, epsilon);
@@ -168,6 +221,15 @@ public:
 	/* Plus operation (open Kleene) */
 	void plus()
 	{
+		/* A single state automaton is already a star, and a plus of a star is the star itself.
+		 * An empty automaton stays empty.
+		 */
+		if (this->getStateCount() <= 1)
+		{
+			return;
+		}
+
+
 		StateId oldLastState = this->getStateCount() - 1;
 		StateId oldEntryState = this->getEntryState();
 		
@@ -184,6 +246,13 @@ public:
 	/* Star operation (Kleene closure) */
 	void star()
 	{
+		/* A single state automaton is already a star. An empty automaton stays empty. */
+		if (this->getStateCount() <= 1)
+		{
+			return;
+		}
+
+
 		StateId oldLastState = this->getStateCount() - 1;
 		StateId oldEntryState = this->getEntryState();
 		
@@ -200,13 +269,26 @@ public:
 			return;
 		}
 		
+		/* The entry state will be able to skip the whole automaton. If it can be reached again
+		 * after consuming some input (a star in first position, for example), a fresh entry state
+		 * is needed, or the skip would be allowed from the middle of the automaton.
+		 */
+		StateId skippingState = oldEntryState;
+		if (hasIncomingTransition(oldEntryState))
+		{
+			this->addState();
+			skippingState = this->getStateCount() - 1;
+			entryState_ = skippingState;
+			this->addTransition(skippingState, oldEntryState, epsilon);
+		}
+
 		this->addTransition(oldLastState, oldEntryState, epsilon);
 
 
 		this->addState();
 		StateId newLastState = this->getStateCount() - 1;
 		this->addTransition(oldLastState, newLastState, epsilon);
-		this->addTransition(oldEntryState, newLastState, epsilon);
+		this->addTransition(skippingState, newLastState, epsilon);
 	}
 
 	/* Return the entry state */
@@ -215,11 +297,31 @@ public:
 		return entryState_;
 	}
 
+	/* Return the work done by the simulations (see 'Counters.hxx') */
+	const Counters& getCounters() const noexcept
+	{
+		return counters_;
+	}
+
+	void resetCounters() noexcept
+	{
+		counters_ = Counters{};
+	}
+
 	/* Return the set of all possible inputs */
 	const std::set<Input>& getPossibleInputs() const noexcept
 	{
 		return possibleInputs_;
 	}
+
+	/* Return the ranges the inputs were given in, a single input being a range of its own.
+	 * The inputs of a range label the transitions of sibling states, always reached together and leading
+	 * to the same state, so they are told apart only by the other ranges they belong to.
+	 */
+	const std::set<InputRange>& getInputRanges() const noexcept
+	{
+		return inputRanges_;
+	}
 	
 	/* Simulate the automaton. Return true if the automaton is matching the given string, false otherwise. */
 	bool simulate(std::string str) const
@@ -227,6 +329,7 @@ public:
 		std::vector<StateId> currentState = this->computeEpsilonClosure(std::vector<StateId>{ getEntryState() });
 		for(auto c : str)
 		{
+			REGEX_COUNT(counters_.transitionsTaken, 1);
 			currentState = this->computeEpsilonClosure(this->makeTransition(currentState, c));
 
 			if(currentState.empty())
@@ -241,58 +344,99 @@ public:
 		return false;
 	}
 	
-	/* Check if the automaton is in a unified form */
+	/* Check if the automaton is in a unified form.
+	 * The entry state must also have no incoming transition (a star or a plus loops back to it),
+	 * otherwise the alternatives added to it would be reachable again from inside the automaton.
+	 */
 	bool isUnified() const noexcept
 	{
 		size_t entryStateEpsilonCount = 0;
 		
-		for(StateId s = 0; s < this->getStateCount(); ++s)
-		{
-			if(s != getEntryState() && this->getTransition(getEntryState(), s) == epsilon)
+		this->forEachTransition(getEntryState(), [this, &entryStateEpsilonCount](StateId to, Input input) {
+			if (to != getEntryState() && input == epsilon)
 			{
 				++entryStateEpsilonCount;
-				if(entryStateEpsilonCount == 2)
-				{
-					return true;
-				}
+			}
+		});
+
+		return entryStateEpsilonCount >= 2 && !hasIncomingTransition(getEntryState());
+	}
+
+	/* Check if some transition leaves the state */
+	bool hasOutgoingTransition(StateId state) const
+	{
+		bool result = false;
+		this->forEachTransition(state, [&result](StateId, Input) { result = true; });
+
+		return result;
+	}
+
+	/* Check if some transition leads to the state */
+	bool hasIncomingTransition(StateId state) const
+	{
+		for (StateId s = 0; s < this->getStateCount(); ++s)
+		{
+			if (this->getTransition(s, state) != none)
+			{
+				return true;
 			}
 		}
-		
+
 		return false;
 	}
 	
 	/* Check if the automaton matches a single character. */
 	bool isSimpleCharacter()
 	{
-		return (this->getStateCount() == 2 && this->getTransition(getEntryState(), getEntryState()) == none);
+		return (this->getStateCount() == 2 && this->getTransition(getEntryState(), getEntryState()) == none
+		        && !hasOutgoingTransition(this->getStateCount() - 1));
 	}
 
-	/* Compute the epsilon closure of the transition. */
+	/* Compute the epsilon closure of the transition.
+	 * The result is sorted, and contains every state only once.
+	 */
 	template<class StateSet>
 	auto computeEpsilonClosure(StateSet&& reachableStates) const
 		-> std::enable_if_t<std::is_same<std::remove_reference_t<StateSet>, std::vector<StateId>>::value, std::vector<StateId>>
 	{
-		std::vector<StateId> epsilonClosure{ reachableStates };
-
 		if (possibleInputs_.size() == 0)
 		{
 			return {}; 
 		}
 
-		while (!reachableStates.empty())
+		REGEX_COUNT(counters_.closuresComputed, 1);
+
+		std::vector<bool> visited(this->getStateCount());
+		std::vector<StateId> epsilonClosure;
+		std::vector<StateId> pendingStates;
+
+		for (StateId state : reachableStates)
 		{
-			StateId state = reachableStates.back();
-			reachableStates.pop_back();
-			for (StateId s = 0; s < this->getStateCount(); ++s)
+			if (!visited[state])
 			{
-				if (this->getTransition(state, s) == epsilon)
+				visited[state] = true;
+				epsilonClosure.push_back(state);
+				pendingStates.push_back(state);
+			}
+		}
+
+		while (!pendingStates.empty())
+		{
+			StateId state = pendingStates.back();
+			pendingStates.pop_back();
+
+			this->forEachTransition(state, [&](StateId to, Input input) {
+				if (input == epsilon && !visited[to])
 				{
-					epsilonClosure.push_back(s);
-					reachableStates.push_back(s);
+					visited[to] = true;
+					epsilonClosure.push_back(to);
+					pendingStates.push_back(to);
 				}
-			}
+			});
 		}
 
+		std::sort(epsilonClosure.begin(), epsilonClosure.end());
+
 		return epsilonClosure;
 	}
 	
@@ -307,10 +451,13 @@ private:
 				possibleInputs_.insert(input);
 			}
 		}
+		inputRanges_.insert(other.getInputRanges().begin(), other.getInputRanges().end());
 	}
 
 	StateId entryState_;
 	std::set<Input> possibleInputs_;
+	std::set<InputRange> inputRanges_;
+	mutable Counters counters_;
 };
 
 #endif // NFA_HXX
\ No newline at end of file
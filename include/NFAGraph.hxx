@@ -0,0 +1,159 @@
+#ifndef NFA_GRAPH_HXX
+#define NFA_GRAPH_HXX
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Common.hxx>
+
+/* Set of states with constant time insertion, lookup and clearing.
+ * This is the classic sparse set of Briggs and Torczon : the dense array keeps the states in
+ * insertion order, and the sparse array maps a state to its position in the dense one.
+ * Neither of them needs to be initialized, so clearing the set does not depend on its capacity.
+ */
+class SparseSet
+{
+public:
+	using const_iterator = std::vector<StateId>::const_iterator;
+
+public:
+	SparseSet(size_t capacity = 0);
+	SparseSet(const SparseSet&) = default;
+	SparseSet(SparseSet&&) = default;
+
+	SparseSet& operator=(const SparseSet&) = default;
+	SparseSet& operator=(SparseSet&&) = default;
+
+	/* Change the capacity of the set. The set is cleared. */
+	void resize(size_t capacity);
+
+	/* Insert the state. Return false if it was already in the set. */
+	bool insert(StateId state);
+	bool contains(StateId state) const;
+	void clear() noexcept;
+
+	size_t size() const noexcept;
+	bool empty() const noexcept;
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+
+private:
+	std::vector<StateId> dense_;
+	std::vector<StateId> sparse_;
+	size_t size_;
+};
+
+/* Read only representation of a NFA, used by the subset construction.
+ * The transitions are stored in compressed sparse row form : all the transitions are kept in a
+ * single array, sorted by origin state, and the transitions of a state are found through an array
+ * of offsets. Epsilon transitions are stored apart from the others, so the closure computation
+ * never has to skip the labelled ones.
+ * The state sets handled here are sorted vectors without duplicates, so that two equal sets
+ * always have the same representation, and can be hashed.
+ */
+class NFAGraph
+{
+public:
+	using StateSet = std::vector<StateId>;
+
+	struct Transition
+	{
+		Input input;
+		uint32_t to;
+	};
+
+	/* Hash function for the state sets, to use them as keys of an unordered container */
+	struct StateSetHash
+	{
+		size_t operator()(const StateSet& states) const noexcept;
+	};
+
+public:
+	/* Default constructor. Will build an empty graph. */
+	NFAGraph();
+
+	/* Build the graph of a NFA. The last state of the NFA is its only final state. */
+	template<class TNFA>
+	explicit NFAGraph(const TNFA& nfa)
+	: NFAGraph()
+	{
+		/* An automaton without any input matches nothing, not even the empty string */
+		if (nfa.getPossibleInputs().empty())
+		{
+			return;
+		}
+
+		stateCount_ = nfa.getStateCount();
+		entryState_ = nfa.getEntryState();
+		finalState_ = stateCount_ - 1;
+
+		Ensures(stateCount_ < UINT32_MAX);
+
+		epsilonOffsets_.reserve(stateCount_ + 1);
+		offsets_.reserve(stateCount_ + 1);
+
+		for (StateId from = 0; from < stateCount_; ++from)
+		{
+			epsilonOffsets_.push_back(static_cast<uint32_t>(epsilonTargets_.size()));
+			offsets_.push_back(static_cast<uint32_t>(transitions_.size()));
+
+			nfa.forEachTransition(from, [this](StateId to, Input input) {
+				if (input == epsilon)
+				{
+					epsilonTargets_.push_back(static_cast<uint32_t>(to));
+				}
+				else
+				{
+					transitions_.push_back({ input, static_cast<uint32_t>(to) });
+				}
+			});
+		}
+
+		epsilonOffsets_.push_back(static_cast<uint32_t>(epsilonTargets_.size()));
+		offsets_.push_back(static_cast<uint32_t>(transitions_.size()));
+	}
+
+	NFAGraph(const NFAGraph&) = default;
+	NFAGraph(NFAGraph&&) = default;
+
+	NFAGraph& operator=(const NFAGraph&) = default;
+	NFAGraph& operator=(NFAGraph&&) = default;
+
+	/* Return the epsilon closure of the entry state. Empty if the graph is. */
+	StateSet getEntryClosure(SparseSet& workspace) const;
+
+	/* Compute, in place, the epsilon closure of the states.
+	 * 'workspace' is only used to track the visited states, and must have the capacity of the graph.
+	 */
+	void computeEpsilonClosure(StateSet& states, SparseSet& workspace) const;
+
+	/* Compute the epsilon closure of the states reachable from 'origin' with 'input' */
+	void makeTransition(const StateSet& origin, Input input, StateSet& result, SparseSet& workspace) const;
+
+	/* Check if the set contains the final state */
+	bool containsFinalState(const StateSet& states) const;
+
+	/* Return a literal spelled by every path from the entry state to a final state, empty if none is found.
+	 * Such a literal is read along a chain of states having a single transition, labelled with a byte, and the
+	 * first state of the chain must be on every path. Checking that costs a walk of the graph, so only the
+	 * 'maxCandidates' longest chains are tried.
+	 */
+	std::string findRequiredLiteral(const std::vector<bool>& isFinal, size_t maxCandidates = 16) const;
+
+	size_t getStateCount() const noexcept;
+	StateId getEntryState() const noexcept;
+	StateId getFinalState() const noexcept;
+
+private:
+	std::vector<uint32_t> epsilonOffsets_;
+	std::vector<uint32_t> epsilonTargets_;
+	std::vector<uint32_t> offsets_;
+	std::vector<Transition> transitions_;
+	size_t stateCount_;
+	StateId entryState_;
+	StateId finalState_;
+};
+
+#endif // NFA_GRAPH_HXX
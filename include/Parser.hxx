@@ -9,13 +9,29 @@
 #include <Range.hxx>
 
 
+/* Thrown for an unbalanced parenthesis : a ')' closing nothing, or a '(' never closed */
 class ExtraneousParenthesisException : public std::exception
 {
 public:
-	ExtraneousParenthesisException() = default;
+	explicit ExtraneousParenthesisException(const char* msg = "Unexpected ')'") : msg_{msg}
+	{}
+
 	const char* what() const noexcept override
 	{
-		return "Unexpected ')'";
+		return msg_;
+	}
+
+private:
+	const char* msg_;
+};
+
+class MisplacedRepetitionException : public std::exception
+{
+public:
+	MisplacedRepetitionException() = default;
+	const char* what() const noexcept override
+	{
+		return "Nothing to repeat before '*' or '+'";
 	}
 };
 
@@ -62,7 +78,7 @@ private:
 			if(needEscaping)
 			{
 				needEscaping = false;
-				resultNFA.concatenate({ c });
+				partialResultVector.emplace_back(c);
 				continue;
 			}
 
@@ -75,10 +91,18 @@ private:
 				break;
 
 				case '*' :
+					if (partialResultVector.empty())
+					{
+						throw MisplacedRepetitionException();
+					}
 					partialResultVector.back().star();
 					break;
 
 				case '+' :
+					if (partialResultVector.empty())
+					{
+						throw MisplacedRepetitionException();
+					}
 					partialResultVector.back().plus();
 					break;
 
@@ -101,14 +125,28 @@ private:
 					break;
 
 				case '|' :
+					/* Everything parsed so far is the left side of the union, and the right side extends
+					 * up to the closing parenthesis, or the end of the expression. So the union ends this call.
+					 * The right side holds all the following alternatives, so it is the biggest one :
+					 * add the left side to it rather than copying it, to keep long alternations linear.
+					 * An empty side matches the empty string, so "(a|)b" matches "b".
+					 */
+					for(const auto& part : partialResultVector){ resultNFA.concatenate(part); }
 					intermediateResult = std::move(parseImpl({ it + 1, strSpan.end()}, inParenthesis, recCount + 1));
-					resultNFA.unify(intermediateResult.first);
-					it += intermediateResult.second + 1;
-					if(recCount != 0)
+					if (resultNFA.getStateCount() == 0)
 					{
-						return { resultNFA, std::distance(strSpan.begin(), it) };
+						resultNFA = TNFA{ epsilon };
 					}
-					break;
+					if (intermediateResult.first.getStateCount() == 0)
+					{
+						intermediateResult.first = TNFA{ epsilon };
+					}
+					intermediateResult.first.unify(resultNFA);
+
+					/* The right side ends at the closing parenthesis, or at the end of the expression : an offset,
+					 * as moving the iterator there would go past the end in the second case.
+					 */
+					return { std::move(intermediateResult.first), std::distance(strSpan.begin(), it) + 1 + intermediateResult.second };
 					
 				case '\\' :
 					needEscaping = true;
@@ -125,6 +163,11 @@ private:
 			}
 		}
 
+		if (inParenthesis)
+		{
+			throw ExtraneousParenthesisException("Missing ')'");
+		}
+
 		for(const auto& part : partialResultVector){ resultNFA.concatenate(part); }
 		return { resultNFA, std::distance(strSpan.begin(), strSpan.end()) };
 	}
@@ -133,18 +176,21 @@ private:
 	{
 		static constexpr int8_t rangeValidSize = 2;
 		
+		/* "[a-b]" : the brackets around the two bounds and their separator */
+		if(std::distance(strSpan.begin(), strSpan.end()) < rangeValidSize + 3)
+		{
+			throw BadRangeException(std::string{"Ill-formed range expression : "} + std::string(strSpan.begin(), strSpan.end()));
+		}
+
 		auto first = strSpan.begin() + 1;
 		
-		TNFA resultNFA;
-		
 		auto it = strSpan.begin() + 2;
 		for(; it != strSpan.end() && *it != ']'; ++it){}
 		
 		auto last = it - 1;
 		
-		if(std::distance(first, last) != rangeValidSize)
+		if(it == strSpan.end() || std::distance(first, last) != rangeValidSize)
 		{
-			std::cout << std::distance(first, last) << std::endl;
 			std::string tmpStr{"["};
 			for(auto it = first; it != strSpan.end() && it != last + 1; ++it)
 			{
@@ -158,12 +204,7 @@ private:
 			throw BadRangeException(std::string{"Invalid range : '"} + *first + "' greater lexicographically than '" + *last + "' ! ");
 		}
 		
-		for(auto current = *first; current != *last + 1; ++current)
-		{
-			resultNFA.unify(current);
-		}
-		
-		return resultNFA;
+		return { *first, *last };
 	}
 
 };
@@ -0,0 +1,72 @@
+#ifndef PREFILTER_HXX
+#define PREFILTER_HXX
+
+#include <array>
+#include <string>
+
+#include <ByteClasses.hxx>
+
+/* Fast search of the positions where a match can start.
+ * A match can only start with a byte leaving the entry state of the automaton, and if the automaton
+ * can only go through a single path of bytes before reaching a final state, with the whole literal
+ * prefix spelled by this path. The prefilter skips everything else : when there are only a few
+ * first bytes, they are searched 16 or 32 bytes at a time with SSE2 or AVX2 instructions (whatever
+ * the target supports), like memchr does, and the prefix, if any, is then compared.
+ * Every match may also have to contain a literal somewhere, not only at its start ("error.*timeout" has
+ * to contain "timeout"). If the rest of the string does not contain it, there is no candidate at all, but
+ * find() does not look for it, as it would scan the rest of the string on every call : the caller checks it
+ * once per search.
+ * A scalar version of the search is kept, giving the same results on every target.
+ */
+class Prefilter
+{
+public:
+	/* Largest number of first bytes searched with the vector instructions */
+	static constexpr size_t maxSearchedBytes = 3;
+
+public:
+	/* Default constructor. Will build a disabled prefilter : every position is a candidate. */
+	Prefilter();
+
+	/* Constructs from the bytes a match can start with, the prefix every match starts with, and a literal
+	 * every match contains. The prefix must start with one of the first bytes.
+	 */
+	Prefilter(const ByteClasses::ByteSet& firstBytes, std::string prefix, std::string requiredLiteral = {});
+
+	Prefilter(const Prefilter&) = default;
+	Prefilter(Prefilter&&) = default;
+
+	Prefilter& operator=(const Prefilter&) = default;
+	Prefilter& operator=(Prefilter&&) = default;
+
+	/* Return the first candidate position of [first, last), or last if there is none */
+	const char* find(const char* first, const char* last) const;
+
+	/* Same as find(), without using the vector instructions */
+	const char* findScalar(const char* first, const char* last) const;
+
+	/* Check if [first, last) contains the required literal, which find() does not */
+	bool containsRequiredLiteral(const char* first, const char* last) const;
+
+	bool isEnabled() const noexcept;
+	const ByteClasses::ByteSet& getFirstBytes() const noexcept;
+	const std::string& getPrefix() const noexcept;
+	const std::string& getRequiredLiteral() const noexcept;
+
+private:
+	/* Return the first position of [first, last) holding one of the searched bytes, or last */
+	const char* findSearchedByte(const char* first, const char* last) const;
+
+	/* Check if the prefix is at the position */
+	bool isPrefixAt(const char* position, const char* last) const;
+
+	ByteClasses::ByteSet firstBytes_;
+	std::array<bool, ByteClasses::byteCount> isFirstByte_;
+	std::array<char, maxSearchedBytes> searchedBytes_;
+	size_t searchedByteCount_;
+	std::string prefix_;
+	std::string requiredLiteral_;
+	bool enabled_;
+};
+
+#endif // PREFILTER_HXX
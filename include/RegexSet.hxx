@@ -0,0 +1,137 @@
+#ifndef REGEX_SET_HXX
+#define REGEX_SET_HXX
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <Common.hxx>
+#include <DFA.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+
+/* Set of regexes matched together, in a single pass over the input.
+ * The automata of the patterns are merged into one with NFA::unify, and compiled into a single DFA.
+ * To know which patterns a string matches, the final state of every pattern is tagged with the id of the
+ * pattern, the ids being given in order of addition. As the union makes the patterns share a final state,
+ * each pattern is first followed by an epsilon transition, and it's the state before this transition which
+ * is tagged : it belongs to that pattern only.
+ */
+template<class TLayout>
+class RegexSet
+{
+public:
+	using PatternId = typename DFA<TLayout>::Tag;
+	using PatternIds = typename DFA<TLayout>::TagSet;
+
+public:
+	/* Default constructor. Will build a set matching nothing. */
+	RegexSet()
+	: nfa_{},
+	  taggedStates_{},
+	  patterns_{},
+	  dfa_{},
+	  compiled_{ true }
+	{}
+
+	/* Constructs from a list of patterns, and compile the set */
+	RegexSet(const std::vector<std::string>& patterns)
+	: RegexSet()
+	{
+		for (const auto& pattern : patterns)
+		{
+			add(pattern);
+		}
+		compile();
+	}
+
+	RegexSet(const RegexSet&) = default;
+	RegexSet(RegexSet&&) = default;
+
+	RegexSet& operator=(const RegexSet&) = default;
+	RegexSet& operator=(RegexSet&&) = default;
+
+	/* Add a pattern to the set, and return its id. The set must be compiled again before matching.
+	 * Like its own DFA, a pattern without any input ("", "()") matches nothing : it is kept out of the
+	 * union, and its id tags no state.
+	 */
+	PatternId add(const std::string& pattern)
+	{
+		NFA<TLayout> patternNFA = Parser<NFA<TLayout>>::parse(pattern);
+
+		patterns_.push_back(pattern);
+		compiled_ = false;
+
+		if (patternNFA.getPossibleInputs().empty())
+		{
+			taggedStates_.push_back(std::numeric_limits<StateId>::max());
+			return patterns_.size() - 1;
+		}
+
+		patternNFA.concatenate(NFA<TLayout>(epsilon));
+
+		/* The states of the pattern keep their order after the states already there */
+		taggedStates_.push_back(nfa_.getStateCount() + patternNFA.getStateCount() - 2);
+		nfa_.unify(patternNFA);
+
+		return patterns_.size() - 1;
+	}
+
+	/* Build and minimize the DFA of the set */
+	void compile()
+	{
+		dfa_.buildFrom(nfa_, taggedStates_);
+		dfa_.minimize();
+		compiled_ = true;
+	}
+
+	/* Return the ids of the patterns matching the string, sorted */
+	const PatternIds& match(std::string_view str) const
+	{
+		Ensures(compiled_);
+
+		return dfa_.getMatchingTags(str);
+	}
+
+	/* Check if any pattern of the set matches the string */
+	bool isMatching(std::string_view str) const
+	{
+		Ensures(compiled_);
+
+		return dfa_.simulate(str);
+	}
+
+	/* Return the pattern having the given id */
+	const std::string& getPattern(PatternId id) const
+	{
+		Ensures(id < patterns_.size());
+
+		return patterns_[id];
+	}
+
+	size_t size() const noexcept
+	{
+		return patterns_.size();
+	}
+
+	bool isCompiled() const noexcept
+	{
+		return compiled_;
+	}
+
+	/* Return the DFA of the set. Only up to date once compiled. */
+	const DFA<TLayout>& getDFA() const noexcept
+	{
+		return dfa_;
+	}
+
+private:
+	NFA<TLayout> nfa_;
+	std::vector<StateId> taggedStates_;
+	std::vector<std::string> patterns_;
+	DFA<TLayout> dfa_;
+	bool compiled_;
+};
+
+#endif // REGEX_SET_HXX
@@ -0,0 +1,87 @@
+#ifndef SEARCH_DFA_HXX
+#define SEARCH_DFA_HXX
+
+#include <vector>
+
+#include <ByteClasses.hxx>
+#include <Common.hxx>
+#include <Counters.hxx>
+#include <NFAGraph.hxx>
+#include <Prefilter.hxx>
+#include <TransitionTable.hxx>
+
+/* Pair of automata searching a string for the leftmost longest match of a DFA, in a time linear in the
+ * bytes they scan, instead of running the DFA again from every position where a match could start.
+ *
+ * The forward automaton finds where the match ends. It is unanchored : until a match is seen, it starts a
+ * new thread of the DFA at every position. Its states keep the DFA states of the threads, ordered by the
+ * position they started at, the earliest first, and a DFA state only once, a later thread in the same state
+ * being bound to find the same matches. Once a thread reaches a final state, the threads started after it
+ * can't give the leftmost match anymore, and are dropped, and no thread is started anymore. The last position
+ * where the automaton is final, before it dies, is thus the end of the leftmost longest match. This is the
+ * construction RE2 uses for its longest match mode.
+ * The start state is the only one without a match seen and with the entry thread alone : when the automaton
+ * gets back to it, no earlier position can start a match anymore, so the search resumes at the next candidate
+ * of the prefilter (see 'Prefilter.hxx').
+ * The reverse automaton runs the DFA backward, from its final states, and is run from this end : the furthest
+ * position where it reaches the entry state is the start of the match.
+ *
+ * The threads can make the forward automaton larger than the DFA. Beyond 'maxStateCount' states for one of
+ * the automata, the construction is abandoned, and the search is left to the caller (see DFA::find()).
+ */
+class SearchDFA
+{
+public:
+	/* Default limit of the number of states of each automaton */
+	static constexpr size_t defaultMaxStateCount = 10000;
+
+public:
+	/* Default constructor. Will build disabled automata. */
+	SearchDFA();
+
+	/* Build the automata of a DFA, given by its sealed transition table, indexed by the byte classes, its
+	 * final states and its entry state.
+	 */
+	SearchDFA(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState,
+	          const ByteClasses& byteClasses, size_t maxStateCount = defaultMaxStateCount);
+
+	SearchDFA(const SearchDFA&) = default;
+	SearchDFA(SearchDFA&&) = default;
+
+	SearchDFA& operator=(const SearchDFA&) = default;
+	SearchDFA& operator=(SearchDFA&&) = default;
+
+	/* Return the end of the leftmost longest match starting in [first, last], or nullptr if there is none.
+	 * The scan starts at the first candidate of the prefilter, and skips to the next one whenever it gets
+	 * back to the start state.
+	 */
+	const char* findEnd(const char* first, const char* last, const Prefilter& prefilter, Counters& counters) const;
+
+	/* Return the start of the longest match of [first, end) ending at 'end', which findEnd() returned */
+	const char* findStart(const char* first, const char* end, Counters& counters) const;
+
+	/* False if the construction was abandoned */
+	bool isEnabled() const noexcept;
+
+	/* Number of states of the forward automaton, dead state excluded */
+	size_t getForwardStateCount() const noexcept;
+
+	/* Number of states of the reverse automaton, dead state excluded */
+	size_t getReverseStateCount() const noexcept;
+
+private:
+	/* Build the forward automaton. Return false if it has too many states. */
+	bool buildForward(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState, size_t maxStateCount);
+
+	/* Build the reverse automaton. Return false if it has too many states. */
+	bool buildReverse(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState, size_t maxStateCount);
+
+	ByteClasses byteClasses_;
+	TransitionTable forward_;
+	std::vector<bool> forwardFinalStates_;
+	TransitionTable reverse_;
+	std::vector<bool> reverseFinalStates_;
+	bool enabled_;
+};
+
+#endif // SEARCH_DFA_HXX
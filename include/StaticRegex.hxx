@@ -0,0 +1,519 @@
+#ifndef STATIC_REGEX_HXX
+#define STATIC_REGEX_HXX
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <Parser.hxx>
+
+/* Compiler of the regexes known at compile time (see StaticRegex below).
+ * Everything here is constexpr, and works on fixed size arrays instead of the layouts, which allocate :
+ * the pattern is parsed into a NFA with Thompson's construction, where a state has at most one transition
+ * on a range of bytes and at most two epsilon transitions, and the NFA is determinized by the classic
+ * subset construction, over the byte classes delimited by the ranges of the NFA.
+ * 'NFACapacity' bounds the states of the NFA, and 'MaxStates' the states of the DFA. Going over them, like
+ * having a malformed pattern, throws, which stops the compilation.
+ */
+template<size_t NFACapacity, size_t MaxStates>
+class StaticRegexCompiler
+{
+public:
+	/* Every range adds at most two class boundaries, and a range takes two NFA states */
+	static constexpr size_t maxClassCount = NFACapacity + 1 < 256 ? NFACapacity + 1 : 256;
+
+	/* Target of the missing transitions of the DFA */
+	static constexpr size_t deadState = MaxStates;
+
+	struct Result
+	{
+		std::array<unsigned char, 256> classes{};
+		size_t classCount = 0;
+		std::array<size_t, MaxStates * maxClassCount> next{};
+		std::array<bool, MaxStates> finalStates{};
+		size_t stateCount = 0;
+	};
+
+public:
+	static constexpr Result compile(const char* pattern)
+	{
+		Automaton nfa{};
+		size_t length = std::char_traits<char>::length(pattern);
+		size_t position = 0;
+
+		Fragment fragment = parseAlternation(nfa, pattern, length, position, false);
+
+		return determinize(nfa, fragment);
+	}
+
+	/* Return the transition table, in the smallest type able to index the states. The dead state is the last one. */
+	template<class Entry, size_t StateCount, size_t ClassCount>
+	static constexpr std::array<Entry, (StateCount + 1) * ClassCount> makeTable(const Result& result)
+	{
+		std::array<Entry, (StateCount + 1) * ClassCount> table{};
+
+		for (size_t state = 0; state <= StateCount; ++state)
+		{
+			for (size_t classId = 0; classId < ClassCount; ++classId)
+			{
+				size_t to = state < StateCount ? result.next[state * maxClassCount + classId] : deadState;
+				table[state * ClassCount + classId] = static_cast<Entry>(to == deadState ? StateCount : to);
+			}
+		}
+
+		return table;
+	}
+
+	template<size_t StateCount>
+	static constexpr std::array<bool, StateCount + 1> makeFinalStates(const Result& result)
+	{
+		std::array<bool, StateCount + 1> finalStates{};
+
+		for (size_t state = 0; state < StateCount; ++state)
+		{
+			finalStates[state] = result.finalStates[state];
+		}
+
+		return finalStates;
+	}
+
+private:
+	static constexpr size_t noState = NFACapacity;
+	static constexpr size_t wordCount = (NFACapacity + 63) / 64;
+
+	using StateSet = std::array<uint64_t, wordCount>;
+
+	struct State
+	{
+		bool hasRange = false;
+		unsigned char first = 0;
+		unsigned char last = 0;
+		size_t to = noState;
+		std::array<size_t, 2> epsilon{ { noState, noState } };
+		size_t epsilonCount = 0;
+	};
+
+	/* Part of the automaton matching a part of the pattern, the exit state having no transition yet */
+	struct Fragment
+	{
+		size_t entryState;
+		size_t exitState;
+	};
+
+	struct Automaton
+	{
+		std::array<State, NFACapacity> states{};
+		size_t stateCount = 0;
+		bool hasInput = false;
+
+		constexpr size_t addState()
+		{
+			if (stateCount == NFACapacity)
+			{
+				throw std::length_error("Too many NFA states");
+			}
+
+			return stateCount++;
+		}
+
+		constexpr void addEpsilon(size_t from, size_t to)
+		{
+			State& state = states[from];
+			state.epsilon[state.epsilonCount++] = to;
+		}
+
+		constexpr Fragment makeEmpty()
+		{
+			size_t state = addState();
+			return { state, state };
+		}
+
+		constexpr Fragment makeRange(unsigned char first, unsigned char last)
+		{
+			Fragment fragment{ addState(), addState() };
+			State& state = states[fragment.entryState];
+
+			state.hasRange = true;
+			state.first = first;
+			state.last = last;
+			state.to = fragment.exitState;
+			hasInput = true;
+
+			return fragment;
+		}
+
+		constexpr Fragment concatenate(Fragment lhs, Fragment rhs)
+		{
+			addEpsilon(lhs.exitState, rhs.entryState);
+			return { lhs.entryState, rhs.exitState };
+		}
+
+		constexpr Fragment unify(Fragment lhs, Fragment rhs)
+		{
+			Fragment fragment{ addState(), addState() };
+
+			addEpsilon(fragment.entryState, lhs.entryState);
+			addEpsilon(fragment.entryState, rhs.entryState);
+			addEpsilon(lhs.exitState, fragment.exitState);
+			addEpsilon(rhs.exitState, fragment.exitState);
+
+			return fragment;
+		}
+
+		constexpr Fragment plus(Fragment inner)
+		{
+			size_t exitState = addState();
+
+			addEpsilon(inner.exitState, inner.entryState);
+			addEpsilon(inner.exitState, exitState);
+
+			return { inner.entryState, exitState };
+		}
+
+		constexpr Fragment star(Fragment inner)
+		{
+			Fragment fragment{ addState(), addState() };
+
+			addEpsilon(fragment.entryState, inner.entryState);
+			addEpsilon(fragment.entryState, fragment.exitState);
+			addEpsilon(inner.exitState, inner.entryState);
+			addEpsilon(inner.exitState, fragment.exitState);
+
+			return fragment;
+		}
+	};
+
+	/* Same grammar as the runtime parser (see 'Parser.hxx') : a union extends up to the closing
+	 * parenthesis, or the end of the pattern, and an empty side of a union matches the empty string.
+	 */
+	static constexpr Fragment parseAlternation(Automaton& nfa, const char* pattern, size_t length, size_t& position, bool inParenthesis)
+	{
+		Fragment sequence = parseSequence(nfa, pattern, length, position, inParenthesis);
+
+		if (position < length && pattern[position] == '|')
+		{
+			++position;
+			return nfa.unify(sequence, parseAlternation(nfa, pattern, length, position, inParenthesis));
+		}
+
+		return sequence;
+	}
+
+	/* Parse up to the end of the pattern, or a union, or a closing parenthesis. The last one is left to the caller. */
+	static constexpr Fragment parseSequence(Automaton& nfa, const char* pattern, size_t length, size_t& position, bool inParenthesis)
+	{
+		Fragment sequence = nfa.makeEmpty();
+		Fragment atom{ noState, noState };
+		bool hasAtom = false;
+
+		while (position < length)
+		{
+			char c = pattern[position];
+
+			if (c == '|')
+			{
+				break;
+			}
+			else if (c == ')')
+			{
+				if (!inParenthesis)
+				{
+					throw ExtraneousParenthesisException();
+				}
+				break;
+			}
+			else if (c == '*' || c == '+')
+			{
+				if (!hasAtom)
+				{
+					throw MisplacedRepetitionException();
+				}
+				atom = (c == '*' ? nfa.star(atom) : nfa.plus(atom));
+				++position;
+				continue;
+			}
+
+			if (hasAtom)
+			{
+				sequence = nfa.concatenate(sequence, atom);
+			}
+			hasAtom = true;
+
+			switch (c)
+			{
+				case '(' :
+					++position;
+					atom = parseAlternation(nfa, pattern, length, position, true);
+					if (position == length)
+					{
+						throw ExtraneousParenthesisException("Missing ')'");
+					}
+					++position;
+					break;
+
+				case '\\' :
+					/* A trailing backslash escapes nothing */
+					hasAtom = position + 1 < length;
+					if (hasAtom)
+					{
+						atom = nfa.makeRange(static_cast<unsigned char>(pattern[position + 1]), static_cast<unsigned char>(pattern[position + 1]));
+					}
+					position += 2;
+					break;
+
+				case '[' :
+					if (position + 4 >= length || pattern[position + 2] == ']' || pattern[position + 3] == ']' || pattern[position + 4] != ']')
+					{
+						throw BadRangeException("Ill-formed range expression");
+					}
+					if (pattern[position + 1] > pattern[position + 3])
+					{
+						throw BadRangeException("Invalid range");
+					}
+					atom = nfa.makeRange(static_cast<unsigned char>(pattern[position + 1]), static_cast<unsigned char>(pattern[position + 3]));
+					position += 5;
+					break;
+
+				case '.' :
+					atom = nfa.makeRange(0, 255);
+					++position;
+					break;
+
+				default :
+					atom = nfa.makeRange(static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+					++position;
+			}
+		}
+
+		return hasAtom ? nfa.concatenate(sequence, atom) : sequence;
+	}
+
+	static constexpr bool contains(const StateSet& set, size_t state)
+	{
+		return (set[state / 64] >> (state % 64)) & 1;
+	}
+
+	static constexpr void insert(StateSet& set, size_t state)
+	{
+		set[state / 64] |= uint64_t{ 1 } << (state % 64);
+	}
+
+	/* Call f on every state of the set */
+	template<class F>
+	static constexpr void forEachState(const StateSet& set, F&& f)
+	{
+		for (size_t word = 0; word < wordCount; ++word)
+		{
+			for (uint64_t bits = set[word]; bits != 0; bits &= bits - 1)
+			{
+				f(word * 64 + static_cast<size_t>(__builtin_ctzll(bits)));
+			}
+		}
+	}
+
+	static constexpr size_t hash(const StateSet& set)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (uint64_t word : set)
+		{
+			hash = (hash ^ word) * 1099511628211ull;
+		}
+		return static_cast<size_t>(hash ^ (hash >> 32));
+	}
+
+	static constexpr bool isEmpty(const StateSet& set)
+	{
+		for (uint64_t word : set)
+		{
+			if (word != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static constexpr bool isEqual(const StateSet& lhs, const StateSet& rhs)
+	{
+		for (size_t word = 0; word < wordCount; ++word)
+		{
+			if (lhs[word] != rhs[word])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* Compute, in place, the epsilon closure of the states */
+	static constexpr void computeEpsilonClosure(const Automaton& nfa, StateSet& set)
+	{
+		std::array<size_t, NFACapacity> pendingStates{};
+		size_t pendingCount = 0;
+
+		forEachState(set, [&](size_t state) { pendingStates[pendingCount++] = state; });
+
+		while (pendingCount > 0)
+		{
+			const State& state = nfa.states[pendingStates[--pendingCount]];
+
+			for (size_t i = 0; i < state.epsilonCount; ++i)
+			{
+				if (!contains(set, state.epsilon[i]))
+				{
+					insert(set, state.epsilon[i]);
+					pendingStates[pendingCount++] = state.epsilon[i];
+				}
+			}
+		}
+	}
+
+	static constexpr Result determinize(const Automaton& nfa, Fragment fragment)
+	{
+		Result result{};
+
+		/* The bytes between two range boundaries are in the same class */
+		std::array<bool, 257> isBoundary{};
+		isBoundary[0] = true;
+
+		for (size_t state = 0; state < nfa.stateCount; ++state)
+		{
+			if (nfa.states[state].hasRange)
+			{
+				isBoundary[nfa.states[state].first] = true;
+				isBoundary[nfa.states[state].last + 1] = true;
+			}
+		}
+
+		std::array<unsigned char, 256> representatives{};
+		for (size_t byte = 0; byte < 256; ++byte)
+		{
+			if (isBoundary[byte])
+			{
+				representatives[result.classCount++] = static_cast<unsigned char>(byte);
+			}
+			result.classes[byte] = static_cast<unsigned char>(result.classCount - 1);
+		}
+
+		/* Subset construction. The DFA states are numbered in order of discovery, so exploring them
+		 * in the order of their numbers is enough. They are found back from their NFA state set through
+		 * an open addressing hash table, holding the state ids plus one.
+		 */
+		std::array<StateSet, MaxStates> dfaStates{};
+		std::array<size_t, 2 * MaxStates> buckets{};
+
+		insert(dfaStates[0], fragment.entryState);
+		computeEpsilonClosure(nfa, dfaStates[0]);
+		buckets[hash(dfaStates[0]) % buckets.size()] = 1;
+		result.stateCount = 1;
+
+		for (size_t current = 0; current < result.stateCount; ++current)
+		{
+			/* An automaton without any input matches nothing, not even the empty string */
+			result.finalStates[current] = nfa.hasInput && contains(dfaStates[current], fragment.exitState);
+
+			for (size_t classId = 0; classId < result.classCount; ++classId)
+			{
+				unsigned char byte = representatives[classId];
+				StateSet newState{};
+
+				forEachState(dfaStates[current], [&](size_t state) {
+					const State& nfaState = nfa.states[state];
+					if (nfaState.hasRange && nfaState.first <= byte && byte <= nfaState.last)
+					{
+						insert(newState, nfaState.to);
+					}
+				});
+
+				size_t newStateId = deadState;
+
+				if (!isEmpty(newState))
+				{
+					computeEpsilonClosure(nfa, newState);
+
+					size_t bucket = hash(newState) % buckets.size();
+					while (buckets[bucket] != 0 && !isEqual(dfaStates[buckets[bucket] - 1], newState))
+					{
+						bucket = (bucket + 1) % buckets.size();
+					}
+
+					if (buckets[bucket] != 0)
+					{
+						newStateId = buckets[bucket] - 1;
+					}
+					else
+					{
+						if (result.stateCount == MaxStates)
+						{
+							throw std::length_error("Too many DFA states, raise the maximum state count");
+						}
+						newStateId = result.stateCount++;
+						dfaStates[newStateId] = newState;
+						buckets[bucket] = result.stateCount;
+					}
+				}
+
+				result.next[current * maxClassCount + classId] = newStateId;
+			}
+		}
+
+		return result;
+	}
+};
+
+/* Regex compiled at compile time.
+ * The pattern, with the syntax of the runtime parser, is given as a static array of characters (C++17
+ * does not take string literals as template arguments) :
+ *
+ *     static constexpr char identifier[] = "[a-z]([a-z]|[0-9])*";
+ *     static_assert(StaticRegex<identifier>::simulate("abc1"));
+ *
+ * The DFA is built during the compilation, and the transition table ends in read only memory, indexed
+ * by byte classes, and using the smallest integer type able to hold the state ids. So matching needs no
+ * startup work and no allocation, and can also be done at compile time. A malformed pattern is a
+ * compilation error. The DFA is not minimized, and a pattern with many states may need a higher limit of
+ * constexpr evaluation from the compiler (-fconstexpr-ops-limit for gcc, -fconstexpr-steps for clang).
+ * The dynamic patterns still go through Parser, NFA and DFA.
+ */
+template<const char* Pattern, size_t MaxStates = 256>
+class StaticRegex
+{
+	using Compiler = StaticRegexCompiler<3 * std::char_traits<char>::length(Pattern) + 1, MaxStates>;
+
+	/* Only used in constant expressions, so it is never emitted */
+	static constexpr typename Compiler::Result compiled_ = Compiler::compile(Pattern);
+
+public:
+	/* Number of states of the DFA, the dead state excluded */
+	static constexpr size_t stateCount = compiled_.stateCount;
+	static constexpr size_t classCount = compiled_.classCount;
+
+	using Entry = std::conditional_t<(stateCount <= UINT8_MAX), uint8_t,
+	              std::conditional_t<(stateCount <= UINT16_MAX), uint16_t, uint32_t>>;
+
+	static constexpr Entry entryState = 0;
+	static constexpr Entry deadState = static_cast<Entry>(stateCount);
+
+	static constexpr std::array<unsigned char, 256> classes = compiled_.classes;
+	static constexpr std::array<Entry, (stateCount + 1) * classCount> table = Compiler::template makeTable<Entry, stateCount, classCount>(compiled_);
+	static constexpr std::array<bool, stateCount + 1> finalStates = Compiler::template makeFinalStates<stateCount>(compiled_);
+
+public:
+	/* Simulate the DFA. Return true if the whole string is matched. */
+	static constexpr bool simulate(std::string_view str)
+	{
+		size_t state = entryState;
+
+		for (unsigned char c : str)
+		{
+			state = table[state * classCount + classes[c]];
+		}
+
+		return finalStates[state];
+	}
+};
+
+#endif // STATIC_REGEX_HXX
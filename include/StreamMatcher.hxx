@@ -0,0 +1,95 @@
+#ifndef STREAM_MATCHER_HXX
+#define STREAM_MATCHER_HXX
+
+#include <string_view>
+
+#include <Common.hxx>
+#include <DFA.hxx>
+#include <TransitionTable.hxx>
+
+/* Match of a DFA over an input given in pieces.
+ * The matcher keeps the state reached by the bytes fed so far, so the input can arrive in chunks of any
+ * size, from a socket or a file read for example, without being gathered in a single string first.
+ * The DFA is only read, and must outlive the matcher : a DFA can be shared by matchers of different threads.
+ */
+template<class TLayout>
+class StreamMatcher
+{
+public:
+	/* Constructs a matcher at the entry state of the DFA */
+	explicit StreamMatcher(const DFA<TLayout>& dfa)
+	: dfa_{ dfa },
+	  state_{ static_cast<TransitionTable::Entry>(dfa.getEntryState()) },
+	  byteCount_{ 0 }
+	{}
+
+	StreamMatcher(const StreamMatcher&) = default;
+	StreamMatcher& operator=(const StreamMatcher&) = delete;
+
+	/* Go on with the next bytes of the input. Once the dead state is reached, the rest of the input is skipped. */
+	void feed(const char* data, size_t size)
+	{
+		const TransitionTable::Entry* next = dfa_.getTable().data();
+		const ByteClasses::ClassId* classes = dfa_.getByteClasses().data();
+		const size_t classCount = dfa_.getTable().getAlphabetSize();
+		const TransitionTable::Entry deadState = static_cast<TransitionTable::Entry>(dfa_.getTable().getDeadState());
+		TransitionTable::Entry state = state_;
+
+		byteCount_ += size;
+
+		for (const char* last = data + size; data != last && state != deadState; ++data)
+		{
+			state = next[state * classCount + classes[static_cast<unsigned char>(*data)]];
+		}
+
+		state_ = state;
+	}
+
+	void feed(std::string_view data)
+	{
+		feed(data.data(), data.size());
+	}
+
+	/* Go back to the entry state, to match a new input */
+	void reset() noexcept
+	{
+		state_ = static_cast<TransitionTable::Entry>(dfa_.getEntryState());
+		byteCount_ = 0;
+	}
+
+	/* Check if the input fed so far is matched */
+	bool isMatching() const
+	{
+		return dfa_.isFinal(state_);
+	}
+
+	/* Return the tags of the state reached by the input fed so far (see 'RegexSet.hxx') */
+	const typename DFA<TLayout>::TagSet& getMatchingTags() const
+	{
+		return dfa_.getTags(state_);
+	}
+
+	/* Check if no continuation of the input can be matched. Feeding more bytes is then useless. */
+	bool isDead() const noexcept
+	{
+		return state_ == dfa_.getTable().getDeadState();
+	}
+
+	StateId getState() const noexcept
+	{
+		return state_;
+	}
+
+	/* Number of bytes fed since the construction, or the last reset */
+	size_t getByteCount() const noexcept
+	{
+		return byteCount_;
+	}
+
+private:
+	const DFA<TLayout>& dfa_;
+	TransitionTable::Entry state_;
+	size_t byteCount_;
+};
+
+#endif // STREAM_MATCHER_HXX
@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Pool of threads running tasks, with work stealing.
+ * Every thread has its own queue of tasks, and the submitted tasks are spread over the queues. A thread
+ * takes the tasks from the back of its queue, and when it's empty, steals from the front of the queue of
+ * another thread, so the threads stay busy even when some tasks take much longer than others.
+ * The first exception thrown by a task is kept, and thrown again by wait().
+ */
+class ThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+public:
+	/* Constructs a pool with the given number of threads, one per hardware thread by default */
+	explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+
+	/* Wait for the tasks to end, and join the threads */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(Task task);
+
+	/* Wait until every submitted task is done */
+	void wait();
+
+	size_t getThreadCount() const noexcept;
+
+private:
+	struct Worker
+	{
+		std::deque<Task> tasks;
+		std::mutex mutex;
+	};
+
+	/* Main loop of the thread 'index' */
+	void run(size_t index);
+
+	/* Take a task from the queue of the thread 'index', or steal one from the other threads */
+	bool takeTask(size_t index, Task& task);
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::vector<std::thread> threads_;
+	std::atomic<size_t> nextWorker_;
+
+	/* Protects the counters below, and the exception */
+	std::mutex mutex_;
+	std::condition_variable taskSubmitted_;
+	std::condition_variable tasksDone_;
+	size_t queuedTaskCount_;
+	size_t pendingTaskCount_;
+	std::exception_ptr exception_;
+	bool stopping_;
+};
+
+#endif // THREAD_POOL_HXX
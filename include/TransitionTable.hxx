@@ -0,0 +1,59 @@
+#ifndef TRANSITION_TABLE_HXX
+#define TRANSITION_TABLE_HXX
+
+#include <cstdint>
+#include <vector>
+
+#include <Common.hxx>
+
+/* Flat transition table used by the compiled automata.
+ * The table is stored row-major in a single contiguous buffer : the successor of 'state'
+ * for the symbol 'symbol' lives at next[state * alphabetSize + symbol], so a transition
+ * costs one multiplication and one load, whatever the number of states.
+ * Once sealed, the table contains a dead state, looping on itself for every symbol, and
+ * every missing transition leads to it. The simulation loop thus never has to check
+ * if a transition exists.
+ */
+class TransitionTable
+{
+public:
+	using Entry = uint32_t;
+
+	/* Value of a transition that has not been set yet. Never present in a sealed table. */
+	static constexpr Entry unset = UINT32_MAX;
+
+public:
+	TransitionTable(size_t alphabetSize = 256);
+	TransitionTable(const TransitionTable&) = default;
+	TransitionTable(TransitionTable&&) = default;
+
+	TransitionTable& operator=(const TransitionTable&) = default;
+	TransitionTable& operator=(TransitionTable&&) = default;
+
+	/* Add a state with all its transitions unset, and return its id */
+	StateId addState();
+	void setTransition(StateId from, size_t symbol, StateId to);
+	Entry getTransition(StateId from, size_t symbol) const;
+
+	/* Add the dead state, and redirect every unset transition to it */
+	void seal();
+	bool isSealed() const noexcept;
+
+	/* Remove every state, keeping the alphabet size */
+	void clear();
+
+	StateId getDeadState() const noexcept;
+	size_t getStateCount() const noexcept;
+	size_t getAlphabetSize() const noexcept;
+
+	/* Raw access to the table, for the simulation loops */
+	const Entry* data() const noexcept;
+
+private:
+	std::vector<Entry> next_;
+	size_t alphabetSize_;
+	size_t stateCount_;
+	Entry deadState_;
+};
+
+#endif // TRANSITION_TABLE_HXX
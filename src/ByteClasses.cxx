@@ -0,0 +1,100 @@
+#include <ByteClasses.hxx>
+
+ByteClasses::ByteClasses()
+: classes_{},
+  classCount_{ 1 },
+  unlabelledByte_{ 0 }
+{}
+
+void ByteClasses::refine(const ByteSet& set)
+{
+	/* New id of every class, for the bytes inside and outside the set */
+	std::array<int, byteCount> inside;
+	std::array<int, byteCount> outside;
+	inside.fill(-1);
+	outside.fill(-1);
+
+	size_t newClassCount = 0;
+
+	for (size_t byte = 0; byte < byteCount; ++byte)
+	{
+		auto& newIds = set[byte] ? inside : outside;
+		ClassId oldId = classes_[byte];
+
+		if (newIds[oldId] == -1)
+		{
+			newIds[oldId] = static_cast<int>(newClassCount++);
+		}
+		classes_[byte] = static_cast<ClassId>(newIds[oldId]);
+	}
+
+	classCount_ = newClassCount;
+}
+
+void ByteClasses::refine(unsigned char byte)
+{
+	ByteSet set;
+	set.set(byte);
+	refine(set);
+}
+
+void ByteClasses::merge(const std::vector<ClassId>& classMap)
+{
+	Ensures(classMap.size() == classCount_);
+
+	size_t newClassCount = 0;
+
+	for (auto& classId : classes_)
+	{
+		classId = classMap[classId];
+		newClassCount = std::max<size_t>(newClassCount, classId + 1);
+	}
+
+	classCount_ = newClassCount;
+}
+
+ByteClasses::ClassId ByteClasses::getClass(unsigned char byte) const noexcept
+{
+	return classes_[byte];
+}
+
+size_t ByteClasses::getClassCount() const noexcept
+{
+	return classCount_;
+}
+
+bool ByteClasses::hasUnlabelledClass() const noexcept
+{
+	return unlabelledByte_ < byteCount;
+}
+
+ByteClasses::ClassId ByteClasses::getUnlabelledClass() const
+{
+	Ensures(hasUnlabelledClass());
+
+	return classes_[unlabelledByte_];
+}
+
+Input ByteClasses::getRepresentative(ClassId classId) const
+{
+	for (size_t byte = 0; byte < byteCount; ++byte)
+	{
+		Input input = static_cast<Input>(byte);
+
+		if (classes_[byte] == classId && input != none && input != epsilon && input != any)
+		{
+			return input;
+		}
+	}
+
+	/* The special inputs never label a transition, so they always share their class with
+	 * at least one regular byte. Getting here means the class does not exist.
+	 */
+	Ensures(false);
+	return none;
+}
+
+const ByteClasses::ClassId* ByteClasses::data() const noexcept
+{
+	return classes_.data();
+}
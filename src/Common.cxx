@@ -80,7 +80,17 @@ void MapLayout::addTransition(StateId from, StateId to, Input input)
 	Ensures(input >= 0 || input == epsilon || input == any);
 #endif
 
-	internalMap_[from].insert({ input, to });
+	/* Like the matrix layout, keep at most one transition between two states, and remove it on 'none' */
+	auto& map = internalMap_[from];
+	for (auto elem = map.begin(); elem != map.end();)
+	{
+		elem = (elem->second == to ? map.erase(elem) : std::next(elem));
+	}
+
+	if (input != none)
+	{
+		map.insert({ input, to });
+	}
 }
 
 Input MapLayout::getTransition(StateId from, StateId to) const
@@ -109,7 +119,7 @@ std::vector<StateId> MapLayout::makeTransition(std::vector<StateId> origin, Inpu
 	
 		for (auto destination = range.first; destination != range.second; ++destination)
 		{
-			if(std::find(result.begin(), result.end(), destination->second) == result.end())
+			if(destination->second < getStateCount() && std::find(result.begin(), result.end(), destination->second) == result.end())
 			{
 				result.push_back(destination->second);
 			}
@@ -120,7 +130,7 @@ std::vector<StateId> MapLayout::makeTransition(std::vector<StateId> origin, Inpu
 
 		for (auto destination = rangeAny.first; destination != rangeAny.second; ++destination)
 		{
-			if (std::find(result.begin(), result.end(), destination->second) == result.end())
+			if (destination->second < getStateCount() && std::find(result.begin(), result.end(), destination->second) == result.end())
 			{
 				result.push_back(destination->second);
 			}
@@ -129,4 +139,102 @@ std::vector<StateId> MapLayout::makeTransition(std::vector<StateId> origin, Inpu
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+
+void AdjacencyLayout::addState()
+{
+	states_.push_back({});
+}
+
+void AdjacencyLayout::removeLastState()
+{
+	states_.pop_back();
+}
+
+void AdjacencyLayout::addTransition(StateId from, StateId to, Input input)
+{
+	Ensures(from < getStateCount());
+	Ensures(to < getStateCount());
+
+#ifndef ANY_CHARACTER_SUPPORT
+	Ensures(input >= 0 || input == epsilon);
+#else
+	Ensures(input >= 0 || input == epsilon || input == any);
+#endif
+
+	auto& state = states_[from];
+	auto elem = std::find_if(state.begin(), state.end(),
+		[to](const Transition& transition) {
+			return transition.to == to;
+		});
+
+	if (elem == state.end())
+	{
+		if (input != none)
+		{
+			state.push_back({ to, input });
+		}
+	}
+	else if (input == none)
+	{
+		state.erase(elem);
+	}
+	else
+	{
+		elem->input = input;
+	}
+}
+
+Input AdjacencyLayout::getTransition(StateId from, StateId to) const
+{
+	Ensures(from < getStateCount());
+	Ensures(to < getStateCount());
+
+	auto& state = states_[from];
+	auto elem = std::find_if(state.begin(), state.end(),
+		[to](const Transition& transition) {
+			return transition.to == to;
+		});
+
+	return (elem != state.end() ? elem->input : none);
+}
+
+size_t AdjacencyLayout::getStateCount() const noexcept
+{
+	return states_.size();
+}
+
+// Special function, allowing to simulate a NFA.
+std::vector<StateId> AdjacencyLayout::makeTransition(std::vector<StateId> origin, Input input) const
+{
+	std::vector<StateId> result;
+
+	for (auto state : origin)
+	{
+		forEachTransition(state, [input, &result](StateId to, Input transitionInput) {
+#ifdef ANY_CHARACTER_SUPPORT
+			if (transitionInput == input || transitionInput == any)
+#else
+			if (transitionInput == input)
+#endif
+			{
+				result.push_back(to);
+			}
+		});
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+
+	return result;
+}
+
+void AdjacencyLayout::debugDisplay() const
+{
+	for (StateId from = 0; from < getStateCount(); ++from)
+	{
+		forEachTransition(from, [from](StateId to, Input input) {
+			std::cout << "From : " << from << ",  To : " << to << " = " << (input == epsilon ? "epsilon" : std::string{ input }) << std::endl;
+		});
+	}
+}
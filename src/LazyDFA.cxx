@@ -0,0 +1,170 @@
+#include <LazyDFA.hxx>
+
+bool LazyDFA::simulate(std::string_view str)
+{
+	const TransitionTable::Entry* next = cache_.data();
+	const ByteClasses::ClassId* classes = byteClasses_.data();
+	const size_t classCount = cache_.getAlphabetSize();
+
+	size_t lastFlushPosition = 0;
+	size_t inefficientFlushCount = 0;
+
+	StateId state = entryState_;
+
+	for (auto it = str.begin(); it != str.end(); ++it)
+	{
+		size_t classId = classes[static_cast<unsigned char>(*it)];
+		TransitionTable::Entry to = next[state * classCount + classId];
+
+		if (to == TransitionTable::unset)
+		{
+			const size_t cachedStateCount = states_.size();
+			const size_t flushCount = flushCount_;
+
+			to = static_cast<TransitionTable::Entry>(computeTransition(state, classId));
+			next = cache_.data();
+
+			/* On a flush, check that the cache was reused enough since the previous one */
+			if (flushCount_ != flushCount)
+			{
+				const size_t position = static_cast<size_t>(it - str.begin());
+
+				if (position - lastFlushPosition < minBytesPerState * cachedStateCount
+				    && ++inefficientFlushCount >= maxFlushCount_)
+				{
+					return simulateNFA(to, { it + 1, static_cast<size_t>(str.end() - it - 1) });
+				}
+				lastFlushPosition = position;
+			}
+		}
+
+		state = to;
+	}
+
+	return finalStates_[state];
+}
+
+void LazyDFA::flush()
+{
+	if (!states_.empty())
+	{
+		++flushCount_;
+	}
+
+	cache_.clear();
+	stateIds_.clear();
+	states_.clear();
+	finalStates_.clear();
+	cacheMemory_ = 0;
+
+	/* The dead state loops on itself */
+	addState({});
+	for (size_t classId = 0; classId < cache_.getAlphabetSize(); ++classId)
+	{
+		cache_.setTransition(deadState, classId, deadState);
+	}
+
+	entryState_ = addState(graph_.getEntryClosure(workspace_));
+}
+
+size_t LazyDFA::getCachedStateCount() const noexcept
+{
+	return states_.size();
+}
+
+size_t LazyDFA::getCacheMemory() const noexcept
+{
+	return cacheMemory_;
+}
+
+size_t LazyDFA::getCacheCapacity() const noexcept
+{
+	return cacheCapacity_;
+}
+
+size_t LazyDFA::getFlushCount() const noexcept
+{
+	return flushCount_;
+}
+
+StateId LazyDFA::getEntryState() const noexcept
+{
+	return entryState_;
+}
+
+StateId LazyDFA::computeTransition(StateId from, size_t classId)
+{
+	NFAGraph::StateSet target;
+	graph_.makeTransition(*states_[from], representatives_[classId], target, workspace_);
+
+	StateId to = deadState;
+
+	if (!target.empty())
+	{
+		auto known = stateIds_.find(target);
+
+		if (known != stateIds_.end())
+		{
+			to = known->second;
+		}
+		else if (cacheMemory_ + getStateMemory(target) > cacheCapacity_)
+		{
+			/* The origin state is flushed along with the others, so the transition can't be recorded */
+			flush();
+			return addState(std::move(target));
+		}
+		else
+		{
+			to = addState(std::move(target));
+		}
+	}
+
+	cache_.setTransition(from, classId, to);
+	return to;
+}
+
+StateId LazyDFA::addState(NFAGraph::StateSet&& states)
+{
+	const size_t stateMemory = getStateMemory(states);
+	const bool isFinal = graph_.containsFinalState(states);
+	auto inserted = stateIds_.emplace(std::move(states), cache_.getStateCount());
+
+	if (!inserted.second)
+	{
+		return inserted.first->second;
+	}
+
+	cacheMemory_ += stateMemory;
+	states_.push_back(&inserted.first->first);
+	finalStates_.push_back(isFinal);
+
+	return cache_.addState();
+}
+
+size_t LazyDFA::getStateMemory(const NFAGraph::StateSet& states) const noexcept
+{
+	/* Row of the table, state set, and an estimation of the hash map node and bookkeeping */
+	static constexpr size_t stateOverhead = 64;
+
+	return cache_.getAlphabetSize() * sizeof(TransitionTable::Entry) + states.size() * sizeof(StateId) + stateOverhead;
+}
+
+bool LazyDFA::simulateNFA(StateId from, std::string_view str)
+{
+	const ByteClasses::ClassId* classes = byteClasses_.data();
+
+	NFAGraph::StateSet current{ *states_[from] };
+	NFAGraph::StateSet next;
+
+	for (unsigned char c : str)
+	{
+		graph_.makeTransition(current, representatives_[classes[c]], next, workspace_);
+		if (next.empty())
+		{
+			return false;
+		}
+		std::swap(current, next);
+	}
+
+	return graph_.containsFinalState(current);
+}
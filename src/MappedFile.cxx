@@ -0,0 +1,96 @@
+#include <MappedFile.hxx>
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path)
+: data_{ nullptr },
+  size_{ 0 }
+{
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+	{
+		throw MappedFileException("Can't open '" + path + "' : " + std::strerror(errno));
+	}
+
+	struct stat status;
+	if (::fstat(fd, &status) == -1)
+	{
+		int error = errno;
+		::close(fd);
+		throw MappedFileException("Can't read the size of '" + path + "' : " + std::strerror(error));
+	}
+
+	/* An empty file can't be mapped, and has nothing to be read anyway */
+	if (status.st_size > 0)
+	{
+		void* address = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address == MAP_FAILED)
+		{
+			int error = errno;
+			::close(fd);
+			throw MappedFileException("Can't map '" + path + "' : " + std::strerror(error));
+		}
+
+		data_ = static_cast<const char*>(address);
+		size_ = static_cast<size_t>(status.st_size);
+
+		/* The file is scanned from start to end */
+		::madvise(address, size_, MADV_SEQUENTIAL);
+	}
+
+	::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: data_{ std::exchange(other.data_, nullptr) },
+  size_{ std::exchange(other.size_, 0) }
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		unmap();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+	}
+
+	return *this;
+}
+
+const char* MappedFile::data() const noexcept
+{
+	return data_;
+}
+
+size_t MappedFile::size() const noexcept
+{
+	return size_;
+}
+
+std::string_view MappedFile::getContent() const noexcept
+{
+	return { data_, size_ };
+}
+
+void MappedFile::unmap() noexcept
+{
+	if (data_ != nullptr)
+	{
+		::munmap(const_cast<char*>(data_), size_);
+		data_ = nullptr;
+		size_ = 0;
+	}
+}
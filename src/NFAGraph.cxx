@@ -0,0 +1,281 @@
+#include <NFAGraph.hxx>
+
+SparseSet::SparseSet(size_t capacity)
+: dense_(capacity),
+  sparse_(capacity),
+  size_{ 0 }
+{}
+
+void SparseSet::resize(size_t capacity)
+{
+	dense_.resize(capacity);
+	sparse_.resize(capacity);
+	size_ = 0;
+}
+
+bool SparseSet::insert(StateId state)
+{
+	Ensures(state < sparse_.size());
+
+	if (contains(state))
+	{
+		return false;
+	}
+
+	dense_[size_] = state;
+	sparse_[state] = size_;
+	++size_;
+
+	return true;
+}
+
+bool SparseSet::contains(StateId state) const
+{
+	StateId index = sparse_[state];
+	return index < size_ && dense_[index] == state;
+}
+
+void SparseSet::clear() noexcept
+{
+	size_ = 0;
+}
+
+size_t SparseSet::size() const noexcept
+{
+	return size_;
+}
+
+bool SparseSet::empty() const noexcept
+{
+	return size_ == 0;
+}
+
+SparseSet::const_iterator SparseSet::begin() const noexcept
+{
+	return dense_.begin();
+}
+
+SparseSet::const_iterator SparseSet::end() const noexcept
+{
+	return dense_.begin() + size_;
+}
+
+size_t NFAGraph::StateSetHash::operator()(const StateSet& states) const noexcept
+{
+	/* FNV-1a, fed with whole state ids */
+	size_t hash = 14695981039346656037ULL;
+
+	for (StateId state : states)
+	{
+		hash ^= state;
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+NFAGraph::NFAGraph()
+: epsilonOffsets_{},
+  epsilonTargets_{},
+  offsets_{},
+  transitions_{},
+  stateCount_{ 0 },
+  entryState_{ 0 },
+  finalState_{ 0 }
+{}
+
+NFAGraph::StateSet NFAGraph::getEntryClosure(SparseSet& workspace) const
+{
+	if (stateCount_ == 0)
+	{
+		return {};
+	}
+
+	StateSet closure{ entryState_ };
+	computeEpsilonClosure(closure, workspace);
+
+	return closure;
+}
+
+void NFAGraph::computeEpsilonClosure(StateSet& states, SparseSet& workspace) const
+{
+	workspace.clear();
+
+	for (StateId state : states)
+	{
+		workspace.insert(state);
+	}
+
+	/* The states of the workspace past 'next' are the ones not explored yet */
+	for (auto next = workspace.begin(); next != workspace.end(); ++next)
+	{
+		StateId state = *next;
+
+		for (uint32_t i = epsilonOffsets_[state]; i < epsilonOffsets_[state + 1]; ++i)
+		{
+			workspace.insert(epsilonTargets_[i]);
+		}
+	}
+
+	states.assign(workspace.begin(), workspace.end());
+	std::sort(states.begin(), states.end());
+}
+
+void NFAGraph::makeTransition(const StateSet& origin, Input input, StateSet& result, SparseSet& workspace) const
+{
+	result.clear();
+
+	for (StateId state : origin)
+	{
+		for (uint32_t i = offsets_[state]; i < offsets_[state + 1]; ++i)
+		{
+			const Transition& transition = transitions_[i];
+
+#ifdef ANY_CHARACTER_SUPPORT
+			if (transition.input == input || transition.input == any)
+#else
+			if (transition.input == input)
+#endif
+			{
+				result.push_back(transition.to);
+			}
+		}
+	}
+
+	if (!result.empty())
+	{
+		computeEpsilonClosure(result, workspace);
+	}
+}
+
+bool NFAGraph::containsFinalState(const StateSet& states) const
+{
+	return stateCount_ != 0 && std::binary_search(states.begin(), states.end(), finalState_);
+}
+
+size_t NFAGraph::getStateCount() const noexcept
+{
+	return stateCount_;
+}
+
+StateId NFAGraph::getEntryState() const noexcept
+{
+	return entryState_;
+}
+
+StateId NFAGraph::getFinalState() const noexcept
+{
+	return finalState_;
+}
+
+std::string NFAGraph::findRequiredLiteral(const std::vector<bool>& isFinal, size_t maxCandidates) const
+{
+	/* Check if a final state can be reached from the entry state without going through 'avoided' */
+	std::vector<bool> visited(stateCount_);
+	auto canReachFinalState = [&](StateId avoided) {
+		std::fill(visited.begin(), visited.end(), false);
+		std::vector<StateId> pending;
+
+		if (entryState_ != avoided)
+		{
+			visited[entryState_] = true;
+			pending.push_back(entryState_);
+		}
+
+		while (!pending.empty())
+		{
+			StateId state = pending.back();
+			pending.pop_back();
+
+			if (isFinal[state])
+			{
+				return true;
+			}
+
+			auto visit = [&](StateId to) {
+				if (to != avoided && !visited[to])
+				{
+					visited[to] = true;
+					pending.push_back(to);
+				}
+			};
+			for (uint32_t i = epsilonOffsets_[state]; i < epsilonOffsets_[state + 1]; ++i)
+			{
+				visit(epsilonTargets_[i]);
+			}
+			for (uint32_t i = offsets_[state]; i < offsets_[state + 1]; ++i)
+			{
+				visit(transitions_[i].to);
+			}
+		}
+
+		return false;
+	};
+
+	/* Without any match, there is nothing to look for */
+	if (stateCount_ == 0 || !canReachFinalState(stateCount_))
+	{
+		return {};
+	}
+
+	/* Next state of the chain, or stateCount_ if the state has not a single transition labelled with a byte.
+	 * A match can end in a final state, so a chain stops there.
+	 */
+	auto getChainSuccessor = [this, &isFinal](StateId state) -> StateId {
+		if (!isFinal[state] && epsilonOffsets_[state] == epsilonOffsets_[state + 1] && offsets_[state] + 1 == offsets_[state + 1]
+		    && transitions_[offsets_[state]].input != any)
+		{
+			return transitions_[offsets_[state]].to;
+		}
+		return stateCount_;
+	};
+
+	/* Length of the chain starting at every state, computed once per state. A chain looping on itself can't
+	 * reach a final state, so its length only has to be finite.
+	 */
+	constexpr size_t unknown = SIZE_MAX;
+	std::vector<size_t> chainLengths(stateCount_, unknown);
+	std::vector<StateId> path;
+
+	for (StateId state = 0; state < stateCount_; ++state)
+	{
+		for (StateId next = state; next != stateCount_ && chainLengths[next] == unknown; next = getChainSuccessor(next))
+		{
+			chainLengths[next] = 0;
+			path.push_back(next);
+		}
+		while (!path.empty())
+		{
+			StateId next = getChainSuccessor(path.back());
+			chainLengths[path.back()] = (next == stateCount_ ? 0 : chainLengths[next] + 1);
+			path.pop_back();
+		}
+	}
+
+	std::vector<StateId> candidates;
+	for (StateId state = 0; state < stateCount_; ++state)
+	{
+		if (chainLengths[state] > 0)
+		{
+			candidates.push_back(state);
+		}
+	}
+	std::stable_sort(candidates.begin(), candidates.end(), [&chainLengths](StateId lhs, StateId rhs) {
+		return chainLengths[lhs] > chainLengths[rhs];
+	});
+
+	for (size_t i = 0; i < candidates.size() && i < maxCandidates; ++i)
+	{
+		if (!canReachFinalState(candidates[i]))
+		{
+			std::string literal;
+			for (StateId state = candidates[i]; literal.size() < chainLengths[candidates[i]]; state = getChainSuccessor(state))
+			{
+				literal.push_back(transitions_[offsets_[state]].input);
+			}
+			return literal;
+		}
+	}
+
+	return {};
+}
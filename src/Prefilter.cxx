@@ -0,0 +1,166 @@
+#include <Prefilter.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+Prefilter::Prefilter()
+: Prefilter(ByteClasses::ByteSet{}.set(), {})
+{}
+
+Prefilter::Prefilter(const ByteClasses::ByteSet& firstBytes, std::string prefix, std::string requiredLiteral)
+: firstBytes_{ firstBytes },
+  isFirstByte_{},
+  searchedBytes_{},
+  searchedByteCount_{ 0 },
+  prefix_{ std::move(prefix) },
+  requiredLiteral_{ std::move(requiredLiteral) },
+  enabled_{ !firstBytes.all() || !requiredLiteral_.empty() }
+{
+	Ensures(prefix_.empty() || firstBytes_[static_cast<unsigned char>(prefix_.front())]);
+
+	for (size_t byte = 0; byte < ByteClasses::byteCount; ++byte)
+	{
+		isFirstByte_[byte] = firstBytes_[byte];
+
+		if (firstBytes_[byte])
+		{
+			if (searchedByteCount_ < maxSearchedBytes)
+			{
+				searchedBytes_[searchedByteCount_] = static_cast<char>(byte);
+			}
+			++searchedByteCount_;
+		}
+	}
+
+	/* The unused slots repeat a searched byte, so the vector search always compares with all of them */
+	if (searchedByteCount_ > 0 && searchedByteCount_ < maxSearchedBytes)
+	{
+		std::fill(searchedBytes_.begin() + searchedByteCount_, searchedBytes_.end(), searchedBytes_[0]);
+	}
+}
+
+const char* Prefilter::find(const char* first, const char* last) const
+{
+	if (!enabled_ || searchedByteCount_ > maxSearchedBytes)
+	{
+		return findScalar(first, last);
+	}
+	for (;; ++first)
+	{
+		first = findSearchedByte(first, last);
+
+		if (first == last || isPrefixAt(first, last))
+		{
+			return first;
+		}
+	}
+}
+
+const char* Prefilter::findScalar(const char* first, const char* last) const
+{
+	if (!enabled_)
+	{
+		return first;
+	}
+	for (; first != last; ++first)
+	{
+		if (isFirstByte_[static_cast<unsigned char>(*first)] && isPrefixAt(first, last))
+		{
+			return first;
+		}
+	}
+
+	return last;
+}
+
+bool Prefilter::isEnabled() const noexcept
+{
+	return enabled_;
+}
+
+const ByteClasses::ByteSet& Prefilter::getFirstBytes() const noexcept
+{
+	return firstBytes_;
+}
+
+const std::string& Prefilter::getPrefix() const noexcept
+{
+	return prefix_;
+}
+
+const std::string& Prefilter::getRequiredLiteral() const noexcept
+{
+	return requiredLiteral_;
+}
+
+const char* Prefilter::findSearchedByte(const char* first, const char* last) const
+{
+	if (searchedByteCount_ == 0)
+	{
+		return last;
+	}
+
+#if defined(__AVX2__)
+	const __m256i byte0 = _mm256_set1_epi8(searchedBytes_[0]);
+	const __m256i byte1 = _mm256_set1_epi8(searchedBytes_[1]);
+	const __m256i byte2 = _mm256_set1_epi8(searchedBytes_[2]);
+
+	for (; last - first >= 32; first += 32)
+	{
+		const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+		const __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(block, byte0),
+		                                      _mm256_or_si256(_mm256_cmpeq_epi8(block, byte1), _mm256_cmpeq_epi8(block, byte2)));
+		const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+
+		if (mask != 0)
+		{
+			return first + __builtin_ctz(mask);
+		}
+	}
+#elif defined(__SSE2__)
+	const __m128i byte0 = _mm_set1_epi8(searchedBytes_[0]);
+	const __m128i byte1 = _mm_set1_epi8(searchedBytes_[1]);
+	const __m128i byte2 = _mm_set1_epi8(searchedBytes_[2]);
+
+	for (; last - first >= 16; first += 16)
+	{
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+		const __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, byte0),
+		                                   _mm_or_si128(_mm_cmpeq_epi8(block, byte1), _mm_cmpeq_epi8(block, byte2)));
+		const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+
+		if (mask != 0)
+		{
+			return first + __builtin_ctz(mask);
+		}
+	}
+#endif
+
+	/* Remaining bytes, or every byte if the target has no vector instructions */
+	for (; first != last; ++first)
+	{
+		if (isFirstByte_[static_cast<unsigned char>(*first)])
+		{
+			return first;
+		}
+	}
+
+	return last;
+}
+
+bool Prefilter::isPrefixAt(const char* position, const char* last) const
+{
+	return static_cast<size_t>(last - position) >= prefix_.size()
+	       && std::memcmp(position, prefix_.data(), prefix_.size()) == 0;
+}
+
+bool Prefilter::containsRequiredLiteral(const char* first, const char* last) const
+{
+	return requiredLiteral_.empty()
+	       || std::string_view{ first, static_cast<size_t>(last - first) }.find(requiredLiteral_) != std::string_view::npos;
+}
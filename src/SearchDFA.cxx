@@ -0,0 +1,322 @@
+#include <SearchDFA.hxx>
+
+#include <algorithm>
+#include <unordered_map>
+
+SearchDFA::SearchDFA()
+: byteClasses_{},
+  forward_{ byteClasses_.getClassCount() },
+  forwardFinalStates_{},
+  reverse_{ byteClasses_.getClassCount() },
+  reverseFinalStates_{},
+  enabled_{ false }
+{}
+
+SearchDFA::SearchDFA(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState,
+                     const ByteClasses& byteClasses, size_t maxStateCount)
+: byteClasses_{ byteClasses },
+  forward_{ byteClasses.getClassCount() },
+  forwardFinalStates_{},
+  reverse_{ byteClasses.getClassCount() },
+  reverseFinalStates_{},
+  enabled_{ false }
+{
+	Ensures(table.isSealed() && table.getAlphabetSize() == byteClasses.getClassCount());
+	Ensures(finalStates.size() == table.getStateCount() && entryState < table.getStateCount());
+
+	enabled_ = buildForward(table, finalStates, entryState, maxStateCount) && buildReverse(table, finalStates, entryState, maxStateCount);
+
+	if (!enabled_)
+	{
+		forward_ = TransitionTable{ byteClasses_.getClassCount() };
+		reverse_ = TransitionTable{ byteClasses_.getClassCount() };
+		forwardFinalStates_.clear();
+		reverseFinalStates_.clear();
+	}
+}
+
+const char* SearchDFA::findEnd(const char* first, const char* last, const Prefilter& prefilter, [[maybe_unused]] Counters& counters) const
+{
+	Ensures(enabled_);
+
+	const TransitionTable::Entry* next = forward_.data();
+	const ByteClasses::ClassId* classes = byteClasses_.data();
+	const size_t classCount = forward_.getAlphabetSize();
+	const TransitionTable::Entry deadState = static_cast<TransitionTable::Entry>(forward_.getDeadState());
+	const bool skipsAhead = prefilter.isEnabled();
+	TransitionTable::Entry state = 0;
+
+	const char* position = prefilter.find(first, last);
+	[[maybe_unused]] const char* scanStart = position;
+	const char* matchEnd = forwardFinalStates_[state] ? position : nullptr;
+
+	while (position != last)
+	{
+		state = next[state * classCount + classes[static_cast<unsigned char>(*position++)]];
+
+		if (state == deadState)
+		{
+			break;
+		}
+		if (forwardFinalStates_[state])
+		{
+			matchEnd = position;
+		}
+		else if (state == 0 && skipsAhead)
+		{
+			/* Every thread died without a match, so the scan is back to its start, and can skip to the next candidate */
+			REGEX_COUNT(counters.transitionsTaken, static_cast<size_t>(position - scanStart));
+			position = prefilter.find(position, last);
+			scanStart = position;
+		}
+	}
+
+	REGEX_COUNT(counters.transitionsTaken, static_cast<size_t>(position - scanStart));
+
+	return matchEnd;
+}
+
+const char* SearchDFA::findStart(const char* first, const char* end, [[maybe_unused]] Counters& counters) const
+{
+	Ensures(enabled_);
+
+	const TransitionTable::Entry* next = reverse_.data();
+	const ByteClasses::ClassId* classes = byteClasses_.data();
+	const size_t classCount = reverse_.getAlphabetSize();
+	const TransitionTable::Entry deadState = static_cast<TransitionTable::Entry>(reverse_.getDeadState());
+	TransitionTable::Entry state = 0;
+
+	const char* matchStart = reverseFinalStates_[state] ? end : nullptr;
+	const char* position = end;
+
+	while (position != first)
+	{
+		state = next[state * classCount + classes[static_cast<unsigned char>(*--position)]];
+
+		if (state == deadState)
+		{
+			break;
+		}
+		if (reverseFinalStates_[state])
+		{
+			matchStart = position;
+		}
+	}
+
+	REGEX_COUNT(counters.transitionsTaken, static_cast<size_t>(end - position));
+	Ensures(matchStart != nullptr);
+
+	return matchStart;
+}
+
+bool SearchDFA::isEnabled() const noexcept
+{
+	return enabled_;
+}
+
+size_t SearchDFA::getForwardStateCount() const noexcept
+{
+	return enabled_ ? forward_.getStateCount() - 1 : 0;
+}
+
+size_t SearchDFA::getReverseStateCount() const noexcept
+{
+	return enabled_ ? reverse_.getStateCount() - 1 : 0;
+}
+
+bool SearchDFA::buildForward(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState, size_t maxStateCount)
+{
+	const StateId deadState = table.getDeadState();
+	SparseSet threadStates{ table.getStateCount() };
+
+	/* A state of the forward automaton is stored as a flag telling if a match was seen, followed by the
+	 * DFA states of its threads. The map nodes are stable, so the vector can refer to the keys.
+	 */
+	using Threads = std::vector<StateId>;
+	std::unordered_map<Threads, StateId, NFAGraph::StateSetHash> stateIds;
+	std::vector<const Threads*> states;
+	std::vector<StateId> pendingStates;
+
+	Threads newState;
+	bool isMatching = false;
+
+	/* Append the thread, unless it died or an earlier thread is in the same state. Return true if it is final. */
+	auto appendThread = [&](StateId state) {
+		if (state == deadState || !threadStates.insert(state))
+		{
+			return false;
+		}
+		newState.push_back(state);
+		return bool(finalStates[state]);
+	};
+
+	auto findOrAddState = [&]() {
+		auto inserted = stateIds.emplace(newState, forward_.getStateCount());
+		if (inserted.second)
+		{
+			forward_.addState();
+			forwardFinalStates_.push_back(isMatching);
+			states.push_back(&inserted.first->first);
+			pendingStates.push_back(inserted.first->second);
+		}
+		return inserted.first->second;
+	};
+
+	threadStates.clear();
+	newState.assign(1, 0);
+	isMatching = appendThread(entryState);
+	newState.front() = isMatching;
+	findOrAddState();
+
+	while (!pendingStates.empty())
+	{
+		if (forward_.getStateCount() > maxStateCount)
+		{
+			return false;
+		}
+
+		const StateId currentState = pendingStates.back();
+		pendingStates.pop_back();
+		const Threads& currentThreads = *states[currentState];
+		const bool matchSeen = currentThreads.front() != 0;
+
+		for (size_t classId = 0; classId < byteClasses_.getClassCount(); ++classId)
+		{
+			threadStates.clear();
+			newState.assign(1, 0);
+			isMatching = false;
+
+			/* Move every thread, earliest first. The threads after the first one reaching a final state are dropped. */
+			for (size_t i = 1; i < currentThreads.size() && !isMatching; ++i)
+			{
+				isMatching = appendThread(table.getTransition(currentThreads[i], classId));
+			}
+
+			/* Until a match is seen, a thread starts after every byte */
+			if (!isMatching && !matchSeen)
+			{
+				isMatching = appendThread(entryState);
+			}
+
+			/* Without any thread left, the search is over */
+			if (newState.size() > 1)
+			{
+				newState.front() = matchSeen || isMatching;
+				forward_.setTransition(currentState, classId, findOrAddState());
+			}
+		}
+	}
+
+	forward_.seal();
+	forwardFinalStates_.push_back(false);
+
+	return true;
+}
+
+bool SearchDFA::buildReverse(const TransitionTable& table, const std::vector<bool>& finalStates, StateId entryState, size_t maxStateCount)
+{
+	const size_t stateCount = table.getStateCount();
+	const size_t classCount = table.getAlphabetSize();
+	const StateId deadState = table.getDeadState();
+
+	/* Inverse transitions, in compressed form : the states going to 'to' with 'classId' are stored in
+	 * predecessors[offsets[to * classCount + classId]] up to the offset of the next pair. The dead state
+	 * can't lead to a final state, so its transitions are left out.
+	 */
+	std::vector<size_t> offsets(stateCount * classCount + 1, 0);
+	std::vector<StateId> predecessors;
+
+	for (StateId from = 0; from < stateCount; ++from)
+	{
+		for (size_t classId = 0; classId < classCount && from != deadState; ++classId)
+		{
+			++offsets[table.getTransition(from, classId) * classCount + classId + 1];
+		}
+	}
+	for (size_t i = 1; i < offsets.size(); ++i)
+	{
+		offsets[i] += offsets[i - 1];
+	}
+	predecessors.resize(offsets.back());
+	{
+		std::vector<size_t> filled(offsets.begin(), offsets.end() - 1);
+		for (StateId from = 0; from < stateCount; ++from)
+		{
+			for (size_t classId = 0; classId < classCount && from != deadState; ++classId)
+			{
+				predecessors[filled[table.getTransition(from, classId) * classCount + classId]++] = from;
+			}
+		}
+	}
+
+	/* The reverse automaton starts from every final state, and is final once it reaches the entry state */
+	NFAGraph::StateSet entryStates;
+	for (StateId state = 0; state < stateCount; ++state)
+	{
+		if (finalStates[state])
+		{
+			entryStates.push_back(state);
+		}
+	}
+
+	auto isFinalSet = [entryState](const NFAGraph::StateSet& states) {
+		return std::binary_search(states.begin(), states.end(), entryState);
+	};
+
+	std::unordered_map<NFAGraph::StateSet, StateId, NFAGraph::StateSetHash> stateIds;
+	std::vector<const NFAGraph::StateSet*> states;
+	std::vector<StateId> pendingStates;
+
+	reverse_.addState();
+	reverseFinalStates_.push_back(isFinalSet(entryStates));
+	states.push_back(&stateIds.emplace(entryStates, 0).first->first);
+	pendingStates.push_back(0);
+
+	SparseSet reached{ stateCount };
+	NFAGraph::StateSet newState;
+
+	while (!pendingStates.empty())
+	{
+		if (reverse_.getStateCount() > maxStateCount)
+		{
+			return false;
+		}
+
+		const StateId currentState = pendingStates.back();
+		pendingStates.pop_back();
+
+		for (size_t classId = 0; classId < classCount; ++classId)
+		{
+			reached.clear();
+			for (StateId to : *states[currentState])
+			{
+				const size_t pair = to * classCount + classId;
+				for (size_t i = offsets[pair]; i < offsets[pair + 1]; ++i)
+				{
+					reached.insert(predecessors[i]);
+				}
+			}
+
+			if (!reached.empty())
+			{
+				newState.assign(reached.begin(), reached.end());
+				std::sort(newState.begin(), newState.end());
+
+				auto inserted = stateIds.emplace(newState, reverse_.getStateCount());
+				if (inserted.second)
+				{
+					reverse_.addState();
+					reverseFinalStates_.push_back(isFinalSet(newState));
+					states.push_back(&inserted.first->first);
+					pendingStates.push_back(inserted.first->second);
+				}
+				reverse_.setTransition(currentState, classId, inserted.first->second);
+			}
+		}
+	}
+
+	reverse_.seal();
+	reverseFinalStates_.push_back(false);
+
+	return true;
+}
@@ -0,0 +1,148 @@
+#include <ThreadPool.hxx>
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(size_t threadCount)
+: workers_{},
+  threads_{},
+  nextWorker_{ 0 },
+  mutex_{},
+  taskSubmitted_{},
+  tasksDone_{},
+  queuedTaskCount_{ 0 },
+  pendingTaskCount_{ 0 },
+  exception_{},
+  stopping_{ false }
+{
+	/* The hardware thread count is 0 when unknown */
+	threadCount = std::max<size_t>(threadCount, 1);
+
+	for (size_t index = 0; index < threadCount; ++index)
+	{
+		workers_.push_back(std::make_unique<Worker>());
+	}
+	for (size_t index = 0; index < threadCount; ++index)
+	{
+		threads_.emplace_back(&ThreadPool::run, this, index);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock{ mutex_ };
+		tasksDone_.wait(lock, [this] { return pendingTaskCount_ == 0; });
+		stopping_ = true;
+	}
+	taskSubmitted_.notify_all();
+
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::submit(Task task)
+{
+	/* Counted first, so the task can't be done before being counted */
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		++queuedTaskCount_;
+		++pendingTaskCount_;
+	}
+
+	Worker& worker = *workers_[nextWorker_++ % workers_.size()];
+	{
+		std::lock_guard<std::mutex> lock{ worker.mutex };
+		worker.tasks.push_back(std::move(task));
+	}
+	taskSubmitted_.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock{ mutex_ };
+	tasksDone_.wait(lock, [this] { return pendingTaskCount_ == 0; });
+
+	if (exception_)
+	{
+		std::rethrow_exception(std::exchange(exception_, nullptr));
+	}
+}
+
+size_t ThreadPool::getThreadCount() const noexcept
+{
+	return threads_.size();
+}
+
+void ThreadPool::run(size_t index)
+{
+	Task task;
+
+	while (true)
+	{
+		if (!takeTask(index, task))
+		{
+			std::unique_lock<std::mutex> lock{ mutex_ };
+			taskSubmitted_.wait(lock, [this] { return stopping_ || queuedTaskCount_ > 0; });
+
+			if (stopping_ && queuedTaskCount_ == 0)
+			{
+				return;
+			}
+			continue;
+		}
+
+		std::exception_ptr exception;
+		try
+		{
+			task();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		task = nullptr;
+
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		if (exception && !exception_)
+		{
+			exception_ = exception;
+		}
+		if (--pendingTaskCount_ == 0)
+		{
+			tasksDone_.notify_all();
+		}
+	}
+}
+
+bool ThreadPool::takeTask(size_t index, Task& task)
+{
+	/* Own queue first, from the back, then the other ones in turn, from the front */
+	for (size_t i = 0; i < workers_.size(); ++i)
+	{
+		Worker& worker = *workers_[(index + i) % workers_.size()];
+		std::lock_guard<std::mutex> workerLock{ worker.mutex };
+
+		if (!worker.tasks.empty())
+		{
+			if (i == 0)
+			{
+				task = std::move(worker.tasks.back());
+				worker.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(worker.tasks.front());
+				worker.tasks.pop_front();
+			}
+
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			--queuedTaskCount_;
+			return true;
+		}
+	}
+
+	return false;
+}
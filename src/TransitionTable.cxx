@@ -0,0 +1,85 @@
+#include <TransitionTable.hxx>
+
+TransitionTable::TransitionTable(size_t alphabetSize)
+: next_{},
+  alphabetSize_{ alphabetSize },
+  stateCount_{ 0 },
+  deadState_{ unset }
+{}
+
+StateId TransitionTable::addState()
+{
+	Ensures(!isSealed());
+	Ensures(stateCount_ < unset - 1);
+
+	next_.resize(next_.size() + alphabetSize_, unset);
+
+	return stateCount_++;
+}
+
+void TransitionTable::setTransition(StateId from, size_t symbol, StateId to)
+{
+	Ensures(from < stateCount_);
+	Ensures(to < stateCount_);
+	Ensures(symbol < alphabetSize_);
+
+	next_[from * alphabetSize_ + symbol] = static_cast<Entry>(to);
+}
+
+TransitionTable::Entry TransitionTable::getTransition(StateId from, size_t symbol) const
+{
+	Ensures(from < stateCount_);
+	Ensures(symbol < alphabetSize_);
+
+	return next_[from * alphabetSize_ + symbol];
+}
+
+void TransitionTable::seal()
+{
+	if (isSealed())
+	{
+		return;
+	}
+
+	deadState_ = static_cast<Entry>(addState());
+
+	for (auto& entry : next_)
+	{
+		if (entry == unset)
+		{
+			entry = deadState_;
+		}
+	}
+}
+
+bool TransitionTable::isSealed() const noexcept
+{
+	return deadState_ != unset;
+}
+
+void TransitionTable::clear()
+{
+	next_.clear();
+	stateCount_ = 0;
+	deadState_ = unset;
+}
+
+StateId TransitionTable::getDeadState() const noexcept
+{
+	return deadState_;
+}
+
+size_t TransitionTable::getStateCount() const noexcept
+{
+	return stateCount_;
+}
+
+size_t TransitionTable::getAlphabetSize() const noexcept
+{
+	return alphabetSize_;
+}
+
+const TransitionTable::Entry* TransitionTable::data() const noexcept
+{
+	return next_.data();
+}
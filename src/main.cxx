@@ -1,10 +1,48 @@
 #include <DFA.hxx>
+#include <LineScanner.hxx>
+#include <MappedFile.hxx>
 #include <NFA.hxx>
 #include <Parser.hxx>
+#include <ThreadPool.hxx>
 
-int main() try
+int main(int argc, char** argv) try
 {
-	using StandardNFA = NFA<MatrixLayout>;
+	using StandardNFA = NFA<AdjacencyLayout>;
+
+	/* Grep mode : print the lines of the file containing a match of the regex.
+	 * Like grep, the exit status is 0 if a line matched, 1 if none did, and 2 on error.
+	 * Unlike grep, for which it matches every line, a regex without anything to match ("", "()") is an error :
+	 * the automata built from it match nothing.
+	 */
+	if (argc == 3)
+	{
+		StandardNFA nfa = Parser<StandardNFA>::parse(argv[1]);
+		if (nfa.getPossibleInputs().empty())
+		{
+			std::cerr << "Empty regex : nothing to match" << std::endl;
+			return 2;
+		}
+
+		DFA<AdjacencyLayout> dfa{ nfa };
+		dfa.minimize();
+
+		MappedFile file{ argv[2] };
+		ThreadPool pool;
+		LineScanner<AdjacencyLayout> scanner{ dfa, pool };
+
+		auto lines = scanner.scan(file.getContent());
+		for (const auto& line : lines)
+		{
+			std::cout << line.number << ':' << line.text << '\n';
+		}
+
+		return lines.empty() ? 1 : 0;
+	}
+	else if (argc != 1)
+	{
+		std::cerr << "Usage : " << argv[0] << " [regex file]" << std::endl;
+		return 2;
+	}
 
 	while (true)
 	{
@@ -12,16 +50,25 @@ int main() try
 		StandardNFA nfa;
 
 		std::cout << "Please enter a regex : ";
-		std::cin >> tst;
+		if (!(std::cin >> tst))
+		{
+			break;
+		}
 
 		nfa = Parser<StandardNFA>::parse(tst);
-		DFA<MatrixLayout> dfa;
+		DFA<AdjacencyLayout> dfa;
 		dfa.buildFrom(nfa);
 
+		auto minimization = dfa.minimize();
+		std::cout << "DFA states : " << minimization.statesBefore << " -> " << minimization.statesAfter << " after minimization" << std::endl;
+
 		while (true)
 		{
 			std::cout << "> ";
-			std::cin >> tst;
+			if (!(std::cin >> tst))
+			{
+				return 0;
+			}
 			//nfa.debugDisplay(); std::cout << std::endl;
 			//dfa.debugDisplay();
 			std::cout << (dfa.simulate(tst) ? "match" : "do not match") << std::endl;
@@ -32,13 +79,26 @@ int main() try
 }
 catch (const ExtraneousParenthesisException& e)
 {
-	std::cout << e.what() << std::endl;
+	std::cerr << e.what() << std::endl;
+	return 2;
+}
+catch (const MisplacedRepetitionException& e)
+{
+	std::cerr << e.what() << std::endl;
+	return 2;
 }
 catch (const BadRangeException& e)
 {
-	std::cout << e.what() << std::endl;
+	std::cerr << e.what() << std::endl;
+	return 2;
+}
+catch (const MappedFileException& e)
+{
+	std::cerr << e.what() << std::endl;
+	return 2;
 }
 catch (...)
 {
-	std::cout << "Unhandled exception !" << std::endl;
+	std::cerr << "Unhandled exception !" << std::endl;
+	return 2;
 }
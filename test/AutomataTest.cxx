@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ByteClasses.hxx>
+#include <DFA.hxx>
+#include <LazyDFA.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+#include <RegexSet.hxx>
+
+#include <Layouts.hxx>
+#include <RandomRegex.hxx>
+#include <ReferenceMatcher.hxx>
+#include <Test.hxx>
+
+namespace
+{
+	constexpr size_t patternCount = 1500;
+	constexpr size_t inputCount = 60;
+	constexpr size_t maxInputLength = 8;
+
+	/* Number of states of the minimal DFA, dead state excluded, computed with Moore's algorithm :
+	 * the states are split by the blocks their transitions lead to, until the partition stops changing.
+	 */
+	template<class TLayout>
+	size_t computeMooreStateCount(const DFA<TLayout>& dfa)
+	{
+		const TransitionTable& table = dfa.getTable();
+		const size_t stateCount = table.getStateCount();
+
+		std::vector<size_t> blocks(stateCount);
+		for (StateId state = 0; state < stateCount; ++state)
+		{
+			blocks[state] = dfa.isFinal(state);
+		}
+
+		for (size_t blockCount = 0; ; )
+		{
+			std::map<std::vector<size_t>, size_t> blockIds;
+			std::vector<size_t> newBlocks(stateCount);
+
+			for (StateId state = 0; state < stateCount; ++state)
+			{
+				std::vector<size_t> signature{ blocks[state] };
+				for (size_t classId = 0; classId < table.getAlphabetSize(); ++classId)
+				{
+					signature.push_back(blocks[table.getTransition(state, classId)]);
+				}
+				newBlocks[state] = blockIds.emplace(std::move(signature), blockIds.size()).first->second;
+			}
+
+			blocks = std::move(newBlocks);
+			if (blockIds.size() == blockCount)
+			{
+				/* The dead state has a block of its own */
+				return blockCount - 1;
+			}
+			blockCount = blockIds.size();
+		}
+	}
+
+	/* Simulate a layout like a NFA does, from the entry state : the epsilon transitions are followed, and the
+	 * any input matches every byte. Return true if one of the states reached at the end is final.
+	 */
+	template<class TLayout, class F>
+	bool simulateLayout(const Layout<TLayout>& layout, StateId entryState, F&& isFinal, const std::string& input)
+	{
+		auto computeEpsilonClosure = [&layout](std::set<StateId> states) {
+			std::vector<StateId> pendingStates(states.begin(), states.end());
+			while (!pendingStates.empty())
+			{
+				StateId state = pendingStates.back();
+				pendingStates.pop_back();
+
+				layout.forEachTransition(state, [&](StateId to, Input transitionInput) {
+					if (transitionInput == epsilon && states.insert(to).second)
+					{
+						pendingStates.push_back(to);
+					}
+				});
+			}
+			return states;
+		};
+
+		std::set<StateId> states = computeEpsilonClosure({ entryState });
+		for (char c : input)
+		{
+			std::set<StateId> nextStates;
+			for (StateId state : states)
+			{
+				layout.forEachTransition(state, [&](StateId to, Input transitionInput) {
+					if (transitionInput == c || transitionInput == any)
+					{
+						nextStates.insert(to);
+					}
+				});
+			}
+			states = computeEpsilonClosure(std::move(nextStates));
+		}
+
+		return std::any_of(states.begin(), states.end(), isFinal);
+	}
+}
+
+TEST_CASE(nfaMatchesReference)
+{
+	forEachLayout([](auto layout) {
+		using TLayout = decltype(layout);
+		RandomRegex random{ 1 };
+
+		for (size_t i = 0; i < patternCount; ++i)
+		{
+			std::string pattern = random.makePattern();
+			ReferenceMatcher reference{ pattern };
+			NFA<TLayout> nfa = Parser<NFA<TLayout>>::parse(pattern);
+
+			for (size_t j = 0; j < inputCount; ++j)
+			{
+				std::string input = random.makeInput(maxInputLength);
+				CHECK(nfa.simulate(input) == reference.matches(input)) << pattern << " on '" << input << "'";
+			}
+		}
+	});
+}
+
+TEST_CASE(dfaMatchesReference)
+{
+	forEachLayout([](auto layout) {
+		using TLayout = decltype(layout);
+		RandomRegex random{ 2 };
+
+		for (size_t i = 0; i < patternCount; ++i)
+		{
+			std::string pattern = random.makePattern();
+			ReferenceMatcher reference{ pattern };
+			DFA<TLayout> dfa{ Parser<NFA<TLayout>>::parse(pattern) };
+			DFA<TLayout> minimalDfa = dfa;
+			minimalDfa.minimize();
+
+			for (size_t j = 0; j < inputCount; ++j)
+			{
+				std::string input = random.makeInput(maxInputLength);
+				bool expected = reference.matches(input);
+
+				CHECK(dfa.simulate(input) == expected) << pattern << " on '" << input << "'";
+				CHECK(minimalDfa.simulate(input) == expected) << pattern << " on '" << input << "', minimized";
+			}
+		}
+	});
+}
+
+TEST_CASE(minimizationMatchesMoore)
+{
+	RandomRegex random{ 3 };
+
+	for (size_t i = 0; i < 2 * patternCount; ++i)
+	{
+		std::string pattern = random.makePattern();
+		DFA<AdjacencyLayout> dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+
+		size_t expected = computeMooreStateCount(dfa);
+		auto report = dfa.minimize();
+
+		CHECK(report.statesAfter == expected) << pattern << " : " << report.statesAfter << " states instead of " << expected;
+		CHECK(dfa.getStateCount() == report.statesAfter) << pattern;
+		CHECK(dfa.minimize().statesAfter == report.statesAfter) << pattern << " : minimizing twice changed the state count";
+	}
+}
+
+TEST_CASE(rangesShareByteClasses)
+{
+	auto countClasses = [](const std::string& pattern) {
+		return ByteClasses::buildFrom(Parser<NFA<AdjacencyLayout>>::parse(pattern)).getClassCount();
+	};
+
+	CHECK(countClasses("[a-z]") == 2);
+	CHECK(countClasses("[a-z]+=[0-9]") == 4);
+	CHECK(countClasses("([a-z]|[A-Z])([a-z]|[A-Z]|[0-9])+=[0-9]+") == 5);
+	CHECK(countClasses("[a-c]|b") == 3);
+	CHECK(countClasses("[a-c][b-d]") == 4);
+}
+
+TEST_CASE(lazyDfaMatchesDfa)
+{
+	RandomRegex random{ 4 };
+
+	for (size_t i = 0; i < patternCount; ++i)
+	{
+		std::string pattern = random.makePattern();
+		NFA<AdjacencyLayout> nfa = Parser<NFA<AdjacencyLayout>>::parse(pattern);
+		DFA<AdjacencyLayout> dfa{ nfa };
+
+		/* A cache large enough, one flushed all the time, and one falling back to the NFA at once */
+		LazyDFA largeCache{ nfa };
+		LazyDFA smallCache{ nfa, 600, 2 };
+		LazyDFA noCache{ nfa, 0, 0 };
+
+		for (size_t j = 0; j < inputCount; ++j)
+		{
+			std::string input = random.makeInput(3 * maxInputLength);
+			bool expected = dfa.simulate(input);
+
+			CHECK(largeCache.simulate(input) == expected) << pattern << " on '" << input << "'";
+			CHECK(smallCache.simulate(input) == expected) << pattern << " on '" << input << "', small cache";
+			CHECK(noCache.simulate(input) == expected) << pattern << " on '" << input << "', no cache";
+		}
+	}
+}
+
+TEST_CASE(regexSetMatchesDfas)
+{
+	forEachLayout([](auto layout) {
+		using TLayout = decltype(layout);
+		RandomRegex random{ 5 };
+
+		for (size_t i = 0; i < patternCount / 4; ++i)
+		{
+			std::vector<std::string> patterns;
+			std::vector<DFA<TLayout>> dfas;
+
+			for (size_t count = 1 + random.next(8); count > 0; --count)
+			{
+				patterns.push_back(random.makePattern());
+				dfas.emplace_back(Parser<NFA<TLayout>>::parse(patterns.back()));
+			}
+
+			RegexSet<TLayout> set{ patterns };
+
+			for (size_t j = 0; j < inputCount; ++j)
+			{
+				std::string input = random.makeInput(maxInputLength);
+				typename RegexSet<TLayout>::PatternIds expected;
+
+				for (size_t id = 0; id < dfas.size(); ++id)
+				{
+					if (dfas[id].simulate(input))
+					{
+						expected.push_back(id);
+					}
+				}
+
+				CHECK(set.match(input) == expected) << patterns.front() << " and " << patterns.size() - 1 << " more on '" << input << "'";
+				CHECK(set.isMatching(input) == !expected.empty()) << patterns.front() << " on '" << input << "'";
+			}
+		}
+	});
+}
+
+TEST_CASE(emptyRegexSetMatchesNothing)
+{
+	RegexSet<AdjacencyLayout> set;
+
+	CHECK(set.match("a").empty());
+	CHECK(!set.isMatching(""));
+
+	RegexSet<AdjacencyLayout>::PatternId id = set.add("ab*");
+	set.add("a.*");
+	set.compile();
+
+	CHECK(id == 0);
+	CHECK(set.match("abb") == (RegexSet<AdjacencyLayout>::PatternIds{ 0, 1 }));
+	CHECK(set.match("ac") == (RegexSet<AdjacencyLayout>::PatternIds{ 1 }));
+
+	/* A pattern without any input matches nothing, as its own DFA does, alone or among others */
+	CHECK(!DFA<AdjacencyLayout>{ Parser<NFA<AdjacencyLayout>>::parse("") }.simulate(""));
+	CHECK(RegexSet<AdjacencyLayout>{ { "" } }.match("").empty());
+
+	RegexSet<AdjacencyLayout> withEmpty{ { "", "a", "()", "|", "b*" } };
+	CHECK(withEmpty.match("") == (RegexSet<AdjacencyLayout>::PatternIds{ 4 }));
+	CHECK(withEmpty.match("a") == (RegexSet<AdjacencyLayout>::PatternIds{ 1 }));
+	CHECK(!withEmpty.isMatching("c"));
+}
+
+TEST_CASE(layoutMatchesTable)
+{
+	forEachLayout([](auto layout) {
+		using TLayout = decltype(layout);
+		RandomRegex random{ 11 };
+
+		for (size_t i = 0; i < patternCount / 4; ++i)
+		{
+			std::string pattern = random.makePattern();
+			DFA<TLayout> dfa{ Parser<NFA<TLayout>>::parse(pattern) };
+			if (i % 2 == 0)
+			{
+				dfa.minimize();
+			}
+
+			Layout<TLayout> dfaLayout = dfa.buildLayout();
+			auto isFinal = [&dfa](StateId state) { return state < dfa.getStateCount() && dfa.isFinal(state); };
+
+			CHECK(dfaLayout.getStateCount() >= dfa.getStateCount()) << pattern;
+
+			for (size_t j = 0; j < inputCount; ++j)
+			{
+				std::string input = random.makeInput(maxInputLength);
+				CHECK(simulateLayout(dfaLayout, dfa.getEntryState(), isFinal, input) == dfa.simulate(input)) << pattern << " on '" << input << "'";
+			}
+		}
+
+		/* The bytes '.' stands for label no NFA transition */
+		DFA<TLayout> dfa{ Parser<NFA<TLayout>>::parse("a.") };
+		StateId afterA = *dfa.makeTransition(dfa.getEntryState(), 'a');
+		StateId afterDot = *dfa.makeTransition(afterA, 'z');
+
+		CHECK(dfa.getTransition(dfa.getEntryState(), afterA) == 'a');
+		CHECK(dfa.getTransition(afterA, afterDot) == any);
+	});
+}
+
+TEST_CASE(parserRejectsMisplacedRepetition)
+{
+	for (const char* pattern : { "*a", "+", "(*a)", "a|+b", "(a|*b)c" })
+	{
+		bool thrown = false;
+		try
+		{
+			Parser<NFA<AdjacencyLayout>>::parse(pattern);
+		}
+		catch (const MisplacedRepetitionException&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown) << pattern;
+	}
+
+	CHECK(DFA<AdjacencyLayout>{ Parser<NFA<AdjacencyLayout>>::parse("(a*)+b") }.simulate("aab"));
+}
@@ -0,0 +1,240 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <DFA.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+#include <RegexSet.hxx>
+#include <SearchDFA.hxx>
+
+#include <RandomRegex.hxx>
+#include <Test.hxx>
+
+namespace
+{
+	using TestDFA = DFA<AdjacencyLayout>;
+
+	constexpr size_t patternCount = 4000;
+	constexpr size_t inputCount = 20;
+
+	/* Leftmost match starting at or after 'from', and the longest one starting there, by trying every substring */
+	optional<TestDFA::Match> findByBruteForce(const TestDFA& dfa, std::string_view input, size_t from)
+	{
+		for (size_t start = from; start <= input.size(); ++start)
+		{
+			for (size_t end = input.size() + 1; end-- > start; )
+			{
+				if (dfa.simulate(input.substr(start, end - start)))
+				{
+					return TestDFA::Match{ start, end };
+				}
+			}
+		}
+
+		return {};
+	}
+}
+
+/* Outside of the anonymous namespace, to be found by the comparison of the vectors of matches */
+static bool operator==(const TestDFA::Match& lhs, const TestDFA::Match& rhs)
+{
+	return lhs.start == rhs.start && lhs.end == rhs.end;
+}
+
+TEST_CASE(findMatchesBruteForce)
+{
+	RandomRegex random{ 6 };
+
+	for (size_t i = 0; i < patternCount; ++i)
+	{
+		std::string pattern = random.makePattern();
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+		if (i % 2 == 0)
+		{
+			dfa.minimize();
+		}
+
+		for (size_t j = 0; j < inputCount; ++j)
+		{
+			std::string input = random.makeInput(60, "abcxyz");
+			size_t from = random.next(input.size() + 1);
+
+			auto expected = findByBruteForce(dfa, input, from);
+			auto match = dfa.find(input, from);
+
+			CHECK(bool(match) == bool(expected)) << pattern << " in '" << input << "' from " << from;
+			if (match && expected)
+			{
+				CHECK(*match == *expected) << pattern << " in '" << input << "' from " << from << " : [" << match->start << ", "
+				                           << match->end << ") instead of [" << expected->start << ", " << expected->end << ")";
+			}
+		}
+	}
+}
+
+TEST_CASE(regexSetFindMatchesBruteForce)
+{
+	RandomRegex random{ 12 };
+
+	for (size_t i = 0; i < patternCount / 8; ++i)
+	{
+		std::vector<std::string> patterns;
+		for (size_t count = 1 + random.next(4); count > 0; --count)
+		{
+			patterns.push_back(random.makePattern());
+		}
+
+		RegexSet<AdjacencyLayout> set{ patterns };
+		const TestDFA& dfa = set.getDFA();
+
+		for (size_t j = 0; j < inputCount; ++j)
+		{
+			std::string input = random.makeInput(60, "abcxyz");
+			auto expected = findByBruteForce(dfa, input, 0);
+			auto match = dfa.find(input);
+
+			CHECK(bool(match) == bool(expected) && (!match || *match == *expected)) << patterns.front() << " and "
+			                                                                      << patterns.size() - 1 << " more in '" << input << "'";
+		}
+	}
+}
+
+TEST_CASE(findAllResumesAfterMatches)
+{
+	RandomRegex random{ 7 };
+
+	for (size_t i = 0; i < patternCount / 4; ++i)
+	{
+		std::string pattern = random.makePattern();
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+		std::string input = random.makeInput(200, "abcxyz");
+
+		std::vector<TestDFA::Match> expected;
+		for (size_t from = 0; from <= input.size(); )
+		{
+			auto match = findByBruteForce(dfa, input, from);
+			if (!match)
+			{
+				break;
+			}
+			expected.push_back(*match);
+			from = match->end + (match->end == match->start ? 1 : 0);
+		}
+
+		CHECK(dfa.findAll(input) == expected) << pattern << " in '" << input << "'";
+	}
+}
+
+TEST_CASE(prefilterSearchIsScalarSearch)
+{
+	RandomRegex random{ 8 };
+
+	for (size_t i = 0; i < patternCount / 4; ++i)
+	{
+		std::string pattern = random.makePattern();
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+		const Prefilter& prefilter = dfa.getPrefilter();
+		std::string input = random.makeInput(100, "abcxyz");
+
+		for (size_t from = 0; from <= input.size(); ++from)
+		{
+			const char* first = input.data() + from;
+			const char* last = input.data() + input.size();
+
+			CHECK(prefilter.find(first, last) == prefilter.findScalar(first, last)) << pattern << " in '" << input << "' from " << from;
+		}
+	}
+}
+
+TEST_CASE(findSkipsToLiteralPrefix)
+{
+	std::string input(1 << 20, 'z');
+	input += "xabcab";
+
+	TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse("abc(a|b)+") };
+	dfa.minimize();
+
+	auto match = dfa.find(input);
+
+	CHECK(dfa.getPrefilter().getPrefix() == "abc");
+	CHECK(match && match->start == (1 << 20) + 1 && match->end == input.size());
+}
+
+TEST_CASE(findRequiresInnerLiteral)
+{
+	auto findRequiredLiteral = [](const std::string& pattern) {
+		return TestDFA{ Parser<NFA<AdjacencyLayout>>::parse(pattern) }.getPrefilter().getRequiredLiteral();
+	};
+
+	CHECK(findRequiredLiteral(".*error.*timeout") == "timeout");
+	CHECK(findRequiredLiteral("(a|b)cd") == "cd");
+	CHECK(findRequiredLiteral("bba*") == "bb");
+	CHECK(findRequiredLiteral("abc|abd").empty());
+	CHECK(findRequiredLiteral("a*").empty());
+
+	TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(".*error.*timeout") };
+	const std::string_view noTimeout = "error, then error again, and no time out";
+	CHECK(!dfa.getPrefilter().containsRequiredLiteral(noTimeout.data(), noTimeout.data() + noTimeout.size()));
+	CHECK(!dfa.find(noTimeout));
+	CHECK(dfa.find("error, then error again, and a timeout") && dfa.find("error, then a timeout")->end == 21);
+}
+
+TEST_CASE(findScansOnceWithoutMatch)
+{
+	/* Running the DFA from every position would take a few minutes */
+	std::string input(1 << 18, 'a');
+
+	/* Patterns, and the end making them match */
+	const std::pair<const char*, const char*> patterns[] = { { ".*(y|z)", "y" }, { "[a-b]+(y|z)", "z" }, { "a*(xyz|xzy)", "xzy" } };
+
+	for (const auto& pattern : patterns)
+	{
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern.first) };
+		std::vector<TestDFA::Match> expected{ { 0, input.size() + std::string_view{ pattern.second }.size() } };
+
+		CHECK(dfa.getSearchDFA().isEnabled()) << pattern.first;
+		CHECK(!dfa.find(input)) << pattern.first;
+		CHECK(dfa.findAll(input + pattern.second) == expected) << pattern.first;
+	}
+}
+
+TEST_CASE(findSkipsAgainAfterFalseCandidate)
+{
+	/* Candidates of the prefilter every 4096 bytes, none of them matching */
+	std::string input(1 << 18, 'a');
+	for (size_t i = 5; i < input.size(); i += 4096)
+	{
+		input[i] = 'z';
+	}
+
+	TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse("z[0-9]") };
+	CHECK(dfa.getSearchDFA().isEnabled());
+
+	/* The bytes between the candidates are skipped, not scanned by the search automaton */
+	dfa.resetCounters();
+	CHECK(!dfa.find(input));
+	CHECK(!Counters::enabled || dfa.getCounters().transitionsTaken < 2 * input.size() / 4096 + 2) << dfa.getCounters().transitionsTaken.load();
+
+	auto match = dfa.find(input + "z5");
+	CHECK(match && match->start == input.size() && match->end == input.size() + 2);
+}
+
+TEST_CASE(searchDfaGivesUpWhenTooLarge)
+{
+	TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse("(a|b)*a(a|b)(a|b)(a|b)") };
+	std::vector<bool> isFinal(dfa.getTable().getStateCount());
+	for (StateId state = 0; state < isFinal.size(); ++state)
+	{
+		isFinal[state] = dfa.isFinal(state);
+	}
+
+	SearchDFA search{ dfa.getTable(), isFinal, dfa.getEntryState(), dfa.getByteClasses() };
+	SearchDFA smallSearch{ dfa.getTable(), isFinal, dfa.getEntryState(), dfa.getByteClasses(), 4 };
+
+	CHECK(search.isEnabled());
+	CHECK(search.getForwardStateCount() > 4);
+	CHECK(!smallSearch.isEnabled());
+	CHECK(smallSearch.getForwardStateCount() == 0);
+}
@@ -0,0 +1,18 @@
+#ifndef LAYOUTS_HXX
+#define LAYOUTS_HXX
+
+#include <Common.hxx>
+
+/* Call f with an instance of every layout, to run a test on all of them :
+ *
+ *     forEachLayout([](auto layout) { using TLayout = decltype(layout); ... });
+ */
+template<class F>
+void forEachLayout(F&& f)
+{
+	f(MatrixLayout{});
+	f(MapLayout{});
+	f(AdjacencyLayout{});
+}
+
+#endif // LAYOUTS_HXX
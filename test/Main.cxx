@@ -0,0 +1,39 @@
+#include <chrono>
+#include <cstring>
+
+#include <Test.hxx>
+
+/* Run every test case, or only the ones whose name contains the argument */
+int main(int argc, char** argv)
+{
+	size_t runCount = 0;
+
+	for (const auto& testCase : test::getTestCases())
+	{
+		if (argc > 1 && std::strstr(testCase.name, argv[1]) == nullptr)
+		{
+			continue;
+		}
+
+		size_t previousFailureCount = test::getFailureCount();
+		auto start = std::chrono::steady_clock::now();
+
+		try
+		{
+			testCase.function();
+		}
+		catch (const std::exception& e)
+		{
+			test::Failure{ __FILE__, __LINE__, testCase.name } << "Unexpected exception : " << e.what();
+		}
+
+		std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		std::cout << (test::getFailureCount() == previousFailureCount ? "[ OK ] " : "[FAIL] ") << testCase.name
+		          << " (" << duration.count() << " s)" << std::endl;
+		++runCount;
+	}
+
+	std::cout << runCount << " tests run, " << test::getFailureCount() << " failed checks" << std::endl;
+
+	return test::getFailureCount() == 0 ? 0 : 1;
+}
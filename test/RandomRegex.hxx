@@ -0,0 +1,115 @@
+#ifndef RANDOM_REGEX_HXX
+#define RANDOM_REGEX_HXX
+
+#include <random>
+#include <string>
+#include <string_view>
+
+/* Generator of random patterns and inputs, for the differential tests.
+ * The patterns use the whole syntax of the parser (characters, '.', ranges, groups, unions, stars and plus)
+ * over a small alphabet, so that the random inputs often match. They are also valid ECMAScript patterns with
+ * the same meaning, so std::regex can be used as a reference. The empty groups are never generated, as a
+ * pattern holding nothing else, like "()", matches nothing for the parser, and neither are the empty alternatives.
+ */
+class RandomRegex
+{
+public:
+	explicit RandomRegex(unsigned int seed)
+	: random_{ seed }
+	{}
+
+	std::string makePattern()
+	{
+		return makeAlternation(0);
+	}
+
+	/* Return a string of at most 'maxLength' bytes of the alphabet */
+	std::string makeInput(size_t maxLength, std::string_view alphabet = "abcx")
+	{
+		std::string input;
+
+		for (size_t length = random_() % (maxLength + 1); length > 0; --length)
+		{
+			input += alphabet[random_() % alphabet.size()];
+		}
+
+		return input;
+	}
+
+	/* Return a number in [0, bound) */
+	size_t next(size_t bound)
+	{
+		return random_() % bound;
+	}
+
+private:
+	static constexpr size_t maxDepth = 2;
+
+	std::string makeAlternation(size_t depth)
+	{
+		std::string alternation = makeSequence(depth);
+
+		while (random_() % 3 == 0)
+		{
+			alternation += '|' + makeSequence(depth);
+		}
+
+		return alternation;
+	}
+
+	std::string makeSequence(size_t depth)
+	{
+		std::string sequence;
+
+		for (size_t atomCount = 1 + random_() % 3; atomCount > 0; --atomCount)
+		{
+			sequence += makeAtom(depth);
+		}
+
+		return sequence;
+	}
+
+	std::string makeAtom(size_t depth)
+	{
+		std::string atom;
+
+		switch (random_() % 10)
+		{
+			case 0 : case 1 : case 2 : case 3 : case 4 :
+				atom = std::string(1, "abc"[random_() % 3]);
+				break;
+
+			case 5 :
+				atom = ".";
+				break;
+
+			case 6 :
+				/* Overlapping ranges, which split each other's byte classes */
+				atom = (random_() % 2 == 0 ? "[a-b]" : "[b-x]");
+				break;
+
+			default :
+				atom = depth < maxDepth ? '(' + makeAlternation(depth + 1) + ')' : "a";
+		}
+
+		switch (random_() % 6)
+		{
+			case 0 :
+				atom += '*';
+				break;
+
+			case 1 :
+				atom += '+';
+				break;
+
+			default :
+				break;
+		}
+
+		return atom;
+	}
+
+	std::mt19937 random_;
+};
+
+#endif // RANDOM_REGEX_HXX
@@ -0,0 +1,196 @@
+#ifndef REFERENCE_MATCHER_HXX
+#define REFERENCE_MATCHER_HXX
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* Reference implementation of the matching, independent of the automata, for the differential tests.
+ * The pattern is parsed into a syntax tree, and matched by computing, for every node and every start
+ * position, the set of positions where the node can end. It handles the patterns made by RandomRegex,
+ * without empty alternatives or groups, and is only meant for short inputs.
+ */
+class ReferenceMatcher
+{
+public:
+	explicit ReferenceMatcher(std::string_view pattern)
+	: pattern_{ pattern },
+	  position_{ 0 },
+	  root_{ parseAlternation() }
+	{}
+
+	/* Check if the whole input is matched */
+	bool matches(std::string_view input) const
+	{
+		Ends ends;
+		return computeEnds(*root_, input, 0, ends).count(input.size()) != 0;
+	}
+
+private:
+	enum class Kind
+	{
+		Range,
+		Sequence,
+		Alternation,
+		Star,
+		Plus
+	};
+
+	struct Node
+	{
+		Kind kind;
+		unsigned char first = 0;
+		unsigned char last = 0;
+		std::vector<std::unique_ptr<Node>> children{};
+	};
+
+	using Ends = std::map<std::pair<const Node*, size_t>, std::set<size_t>>;
+
+	std::unique_ptr<Node> makeNode(Kind kind)
+	{
+		auto node = std::make_unique<Node>();
+		node->kind = kind;
+		return node;
+	}
+
+	std::unique_ptr<Node> parseAlternation()
+	{
+		auto alternation = makeNode(Kind::Alternation);
+		alternation->children.push_back(parseSequence());
+
+		while (position_ < pattern_.size() && pattern_[position_] == '|')
+		{
+			++position_;
+			alternation->children.push_back(parseSequence());
+		}
+
+		return alternation;
+	}
+
+	std::unique_ptr<Node> parseSequence()
+	{
+		auto sequence = makeNode(Kind::Sequence);
+
+		while (position_ < pattern_.size() && pattern_[position_] != '|' && pattern_[position_] != ')')
+		{
+			char c = pattern_[position_++];
+			std::unique_ptr<Node> atom;
+
+			if (c == '(')
+			{
+				atom = parseAlternation();
+				++position_;
+			}
+			else if (c == '[')
+			{
+				atom = makeNode(Kind::Range);
+				atom->first = static_cast<unsigned char>(pattern_[position_]);
+				atom->last = static_cast<unsigned char>(pattern_[position_ + 2]);
+				position_ += 4;
+			}
+			else
+			{
+				atom = makeNode(Kind::Range);
+				atom->first = (c == '.' ? 0 : static_cast<unsigned char>(c));
+				atom->last = (c == '.' ? 255 : static_cast<unsigned char>(c));
+			}
+
+			while (position_ < pattern_.size() && (pattern_[position_] == '*' || pattern_[position_] == '+'))
+			{
+				auto repetition = makeNode(pattern_[position_++] == '*' ? Kind::Star : Kind::Plus);
+				repetition->children.push_back(std::move(atom));
+				atom = std::move(repetition);
+			}
+
+			sequence->children.push_back(std::move(atom));
+		}
+
+		return sequence;
+	}
+
+	/* Return the positions where the node can end, when starting at 'start' */
+	const std::set<size_t>& computeEnds(const Node& node, std::string_view input, size_t start, Ends& ends) const
+	{
+		auto known = ends.find({ &node, start });
+		if (known != ends.end())
+		{
+			return known->second;
+		}
+
+		std::set<size_t> result;
+
+		switch (node.kind)
+		{
+			case Kind::Range :
+				if (start < input.size() && node.first <= static_cast<unsigned char>(input[start])
+				    && static_cast<unsigned char>(input[start]) <= node.last)
+				{
+					result.insert(start + 1);
+				}
+				break;
+
+			case Kind::Sequence :
+				result.insert(start);
+				for (const auto& child : node.children)
+				{
+					std::set<size_t> next;
+					for (size_t position : result)
+					{
+						const auto& childEnds = computeEnds(*child, input, position, ends);
+						next.insert(childEnds.begin(), childEnds.end());
+					}
+					result = std::move(next);
+				}
+				break;
+
+			case Kind::Alternation :
+				for (const auto& child : node.children)
+				{
+					const auto& childEnds = computeEnds(*child, input, start, ends);
+					result.insert(childEnds.begin(), childEnds.end());
+				}
+				break;
+
+			case Kind::Star :
+			case Kind::Plus :
+			{
+				/* Repeat the child from every position reached so far, until no new position shows up */
+				std::vector<size_t> pending{ start };
+				std::set<size_t> reached;
+
+				while (!pending.empty())
+				{
+					size_t position = pending.back();
+					pending.pop_back();
+
+					for (size_t end : computeEnds(*node.children.front(), input, position, ends))
+					{
+						if (reached.insert(end).second)
+						{
+							pending.push_back(end);
+						}
+					}
+				}
+
+				result = std::move(reached);
+				if (node.kind == Kind::Star)
+				{
+					result.insert(start);
+				}
+				break;
+			}
+		}
+
+		return ends[{ &node, start }] = std::move(result);
+	}
+
+	std::string pattern_;
+	size_t position_;
+	std::unique_ptr<Node> root_;
+};
+
+#endif // REFERENCE_MATCHER_HXX
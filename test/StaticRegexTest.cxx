@@ -0,0 +1,220 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DFA.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+#include <StaticRegex.hxx>
+
+#include <RandomRegex.hxx>
+#include <Test.hxx>
+
+namespace
+{
+	using TestDFA = DFA<AdjacencyLayout>;
+
+	constexpr char identifier[] = "[a-z]([a-z]|[0-9])*";
+	constexpr char optionalPrefix[] = "(a|)b";
+	constexpr char repeatedGroup[] = "(ab)+";
+	constexpr char escapedStar[] = "a\\*";
+	constexpr char anyByte[] = "a.c";
+	constexpr char emptyPattern[] = "";
+
+	static_assert(StaticRegex<identifier>::simulate("abc1"));
+	static_assert(StaticRegex<identifier>::simulate("x"));
+	static_assert(!StaticRegex<identifier>::simulate("1abc"));
+	static_assert(!StaticRegex<identifier>::simulate(""));
+
+	static_assert(StaticRegex<optionalPrefix>::simulate("b"));
+	static_assert(StaticRegex<optionalPrefix>::simulate("ab"));
+	static_assert(!StaticRegex<optionalPrefix>::simulate("aab"));
+
+	static_assert(StaticRegex<repeatedGroup>::simulate("abab"));
+	static_assert(!StaticRegex<repeatedGroup>::simulate(""));
+	static_assert(!StaticRegex<repeatedGroup>::simulate("aba"));
+
+	static_assert(StaticRegex<escapedStar>::simulate("a*"));
+	static_assert(!StaticRegex<escapedStar>::simulate("aa"));
+
+	static_assert(StaticRegex<anyByte>::simulate("a\xff" "c"));
+	static_assert(!StaticRegex<anyByte>::simulate("ac"));
+
+	/* An automaton without any input matches nothing, as for the runtime parser */
+	static_assert(!StaticRegex<emptyPattern>::simulate(""));
+
+	/* A few states are enough, so the table uses bytes */
+	static_assert(sizeof(StaticRegex<identifier>::Entry) == 1);
+
+	/* Every pattern of up to 'maxPatternLength' of these characters is compiled */
+	constexpr std::string_view patternAlphabet = "ab.|()*+";
+	constexpr size_t maxPatternLength = 4;
+	constexpr size_t maxInputLength = 4;
+
+	/* Longest random pattern compiled, as the compiler works on fixed size arrays */
+	constexpr size_t maxRandomPatternLength = 40;
+	constexpr size_t patternCount = 1000;
+	constexpr size_t inputCount = 20;
+
+	using SmallCompiler = StaticRegexCompiler<3 * maxPatternLength + 1, 64>;
+	using LargeCompiler = StaticRegexCompiler<3 * maxRandomPatternLength + 1, 128>;
+
+	/* Simulate the compiled DFA at runtime, like StaticRegex::simulate() does at compile time */
+	template<class Compiler>
+	bool simulateCompiled(const typename Compiler::Result& result, std::string_view input)
+	{
+		size_t state = 0;
+
+		for (unsigned char c : input)
+		{
+			if (state == Compiler::deadState)
+			{
+				break;
+			}
+			state = result.next[state * Compiler::maxClassCount + result.classes[c]];
+		}
+
+		return state != Compiler::deadState && result.finalStates[state];
+	}
+
+	/* Return true if f throws an exception of the given type */
+	template<class Exception, class F>
+	bool throws(F&& f)
+	{
+		try
+		{
+			f();
+		}
+		catch (const Exception&)
+		{
+			return true;
+		}
+		catch (...)
+		{
+		}
+
+		return false;
+	}
+
+	/* Return every string of up to 'maxLength' characters of the alphabet */
+	std::vector<std::string> enumerateStrings(std::string_view alphabet, size_t maxLength)
+	{
+		std::vector<std::string> strings{ "" };
+
+		for (size_t i = 0; i < strings.size(); ++i)
+		{
+			for (size_t j = 0; j < alphabet.size() && strings[i].size() < maxLength; ++j)
+			{
+				strings.push_back(strings[i] + alphabet[j]);
+			}
+		}
+
+		return strings;
+	}
+
+	/* Check that the pattern compiled at compile time and the runtime DFA agree on the inputs, and on
+	 * rejecting the malformed patterns. Return false if the pattern is malformed.
+	 */
+	template<class Compiler>
+	bool checkSameMatches(const std::string& pattern, const std::vector<std::string>& inputs)
+	{
+		typename Compiler::Result result{};
+		TestDFA dfa;
+		bool staticThrows = false;
+		bool runtimeThrows = false;
+
+		try
+		{
+			result = Compiler::compile(pattern.c_str());
+		}
+		catch (const std::exception&)
+		{
+			staticThrows = true;
+		}
+		try
+		{
+			dfa = TestDFA{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+		}
+		catch (const std::exception&)
+		{
+			runtimeThrows = true;
+		}
+
+		CHECK(staticThrows == runtimeThrows) << pattern;
+		if (staticThrows || runtimeThrows)
+		{
+			return false;
+		}
+
+		for (const std::string& input : inputs)
+		{
+			CHECK(simulateCompiled<Compiler>(result, input) == dfa.simulate(input)) << pattern << " on '" << input << "'";
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE(staticRegexRejectsMalformedPatterns)
+{
+	for (const char* pattern : { "*a", "a|+b", "(*a)" })
+	{
+		CHECK(throws<MisplacedRepetitionException>([&]() { SmallCompiler::compile(pattern); })) << pattern;
+		CHECK(throws<MisplacedRepetitionException>([&]() { Parser<NFA<AdjacencyLayout>>::parse(pattern); })) << pattern;
+	}
+	for (const char* pattern : { "a)", "(a))", "(ab", "a(", "(a|b", "((a)" })
+	{
+		CHECK(throws<ExtraneousParenthesisException>([&]() { SmallCompiler::compile(pattern); })) << pattern;
+		CHECK(throws<ExtraneousParenthesisException>([&]() { Parser<NFA<AdjacencyLayout>>::parse(pattern); })) << pattern;
+	}
+	for (const char* pattern : { "[", "a[", "[a-", "[b-a]", "[a]", "[a-b" })
+	{
+		CHECK(throws<BadRangeException>([&]() { SmallCompiler::compile(pattern); })) << pattern;
+		CHECK(throws<BadRangeException>([&]() { Parser<NFA<AdjacencyLayout>>::parse(pattern); })) << pattern;
+	}
+
+	CHECK(throws<std::length_error>([]() { StaticRegexCompiler<64, 4>::compile("abcdef"); }));
+	CHECK(throws<std::length_error>([]() { StaticRegexCompiler<4, 64>::compile("abc"); }));
+}
+
+TEST_CASE(staticRegexMatchesDfaOnEveryShortPattern)
+{
+	const std::vector<std::string> inputs = enumerateStrings("abc", maxInputLength);
+	size_t compiledCount = 0;
+
+	for (const std::string& pattern : enumerateStrings(patternAlphabet, maxPatternLength))
+	{
+		compiledCount += checkSameMatches<SmallCompiler>(pattern, inputs);
+	}
+
+	/* Most patterns are malformed, but not all of them */
+	CHECK(compiledCount > 1000) << compiledCount;
+	CHECK(checkSameMatches<SmallCompiler>("(a|)b", { "b", "ab", "" }));
+}
+
+TEST_CASE(staticRegexMatchesDfaOnRandomPatterns)
+{
+	RandomRegex random{ 10 };
+
+	for (size_t i = 0; i < patternCount; ++i)
+	{
+		std::string pattern = random.makePattern();
+		if (pattern.size() > maxRandomPatternLength)
+		{
+			continue;
+		}
+
+		std::vector<std::string> inputs;
+		for (size_t j = 0; j < inputCount; ++j)
+		{
+			inputs.push_back(random.makeInput(16));
+		}
+
+		/* The DFA is not minimized, so it may be over the limit */
+		if (!throws<std::length_error>([&]() { LargeCompiler::compile(pattern.c_str()); }))
+		{
+			CHECK(checkSameMatches<LargeCompiler>(pattern, inputs)) << pattern;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DFA.hxx>
+#include <LineScanner.hxx>
+#include <NFA.hxx>
+#include <Parser.hxx>
+#include <RegexSet.hxx>
+#include <StreamMatcher.hxx>
+#include <ThreadPool.hxx>
+
+#include <RandomRegex.hxx>
+#include <Test.hxx>
+
+namespace
+{
+	using TestDFA = DFA<AdjacencyLayout>;
+
+	constexpr size_t patternCount = 1000;
+	constexpr size_t inputCount = 20;
+}
+
+TEST_CASE(streamMatcherMatchesSimulate)
+{
+	RandomRegex random{ 9 };
+
+	for (size_t i = 0; i < patternCount; ++i)
+	{
+		std::string pattern = random.makePattern();
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+		StreamMatcher<AdjacencyLayout> matcher{ dfa };
+
+		for (size_t j = 0; j < inputCount; ++j)
+		{
+			std::string input = random.makeInput(16);
+			std::string_view rest = input;
+
+			matcher.reset();
+			while (!rest.empty())
+			{
+				size_t chunkSize = 1 + random.next(rest.size());
+				matcher.feed(rest.substr(0, chunkSize));
+				rest.remove_prefix(chunkSize);
+			}
+
+			CHECK(matcher.isMatching() == dfa.simulate(input)) << pattern << " on '" << input << "'";
+			CHECK(matcher.getByteCount() == input.size()) << pattern << " on '" << input << "'";
+		}
+	}
+}
+
+TEST_CASE(streamMatcherReportsTags)
+{
+	RegexSet<AdjacencyLayout> set{ { "ab*", "a.*", "b" } };
+	StreamMatcher<AdjacencyLayout> matcher{ set.getDFA() };
+
+	matcher.feed("a");
+	matcher.feed("bb");
+	CHECK(matcher.getMatchingTags() == set.match("abb"));
+
+	matcher.feed("c");
+	CHECK(matcher.getMatchingTags() == set.match("abbc"));
+
+	matcher.reset();
+	matcher.feed("c");
+	CHECK(matcher.isDead());
+	CHECK(!matcher.isMatching());
+}
+
+TEST_CASE(lineScannerMatchesFind)
+{
+	RandomRegex random{ 10 };
+	ThreadPool pool{ 3 };
+
+	for (size_t i = 0; i < patternCount / 3; ++i)
+	{
+		std::string pattern = random.makePattern();
+		TestDFA dfa{ Parser<NFA<AdjacencyLayout>>::parse(pattern) };
+
+		std::string text;
+		std::vector<std::string> lines;
+		for (size_t count = random.next(40); count > 0; --count)
+		{
+			lines.push_back(random.makeInput(12));
+			text += lines.back() + '\n';
+		}
+		/* The last line may have no end of line */
+		std::string lastLine = random.makeInput(12);
+		if (!lastLine.empty())
+		{
+			lines.push_back(lastLine);
+			text += lastLine;
+		}
+
+		std::vector<size_t> expected;
+		for (size_t line = 0; line < lines.size(); ++line)
+		{
+			if (dfa.find(lines[line]))
+			{
+				expected.push_back(line + 1);
+			}
+		}
+
+		LineScanner<AdjacencyLayout> scanner{ dfa, pool, 1 + random.next(64) };
+		std::vector<size_t> numbers;
+		for (const auto& line : scanner.scan(text))
+		{
+			CHECK(line.text == lines[line.number - 1]) << pattern << " : line " << line.number;
+			numbers.push_back(line.number);
+		}
+
+		CHECK(numbers == expected) << pattern;
+	}
+}
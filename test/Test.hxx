@@ -0,0 +1,86 @@
+#ifndef TEST_HXX
+#define TEST_HXX
+
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Minimal test harness, run by "make test".
+ * A test is declared with TEST_CASE(name) { ... }, registers itself before main runs, and reports its
+ * failed checks with CHECK(condition), which can be followed by a message :
+ *
+ *     CHECK(dfa.simulate(input) == expected) << pattern << " on '" << input << "'";
+ */
+namespace test
+{
+	struct TestCase
+	{
+		const char* name;
+		void (*function)();
+	};
+
+	inline std::vector<TestCase>& getTestCases()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	inline size_t& getFailureCount()
+	{
+		static size_t failureCount = 0;
+		return failureCount;
+	}
+
+	inline bool registerTestCase(const char* name, void (*function)())
+	{
+		getTestCases().push_back({ name, function });
+		return true;
+	}
+
+	/* Only the first failures are printed, a broken invariant usually breaking many checks */
+	constexpr size_t maxPrintedFailures = 20;
+
+	/* Report of a failed check, printed once the message is complete */
+	class Failure
+	{
+	public:
+		Failure(const char* file, int line, const char* condition)
+		: message_{}
+		{
+			message_ << file << ':' << line << ": check failed: " << condition << ". ";
+		}
+
+		Failure(const Failure&) = delete;
+		Failure& operator=(const Failure&) = delete;
+
+		~Failure()
+		{
+			if (getFailureCount()++ < maxPrintedFailures)
+			{
+				std::cout << message_.str() << std::endl;
+			}
+		}
+
+		template<class T>
+		Failure& operator<<(const T& value)
+		{
+			message_ << value;
+			return *this;
+		}
+
+	private:
+		std::ostringstream message_;
+	};
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static const bool name##Registered = test::registerTestCase(#name, &name); \
+	static void name()
+
+#define CHECK(condition) \
+	if (condition) {} else test::Failure{ __FILE__, __LINE__, #condition }
+
+#endif // TEST_HXX